@@ -0,0 +1,466 @@
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sched.h>
+#include "chan_perf.h"
+#include "chan_stats.h"
+#include "bench_driver.h"
+
+// 统一的参数化基准测试驱动：
+// 从命令行读取 键=值1,值2,... 形式的参数，对各维度做笛卡尔积逐一测试，
+// 每个配置重复多次，结果以表格/CSV/JSON输出。
+// 容量、缓存行大小和元素大小是模板参数，只能在下面列出的取值中选择；
+// 测量部分在bench_driver_dispatch.cc，按元素大小分成多个目标文件编译
+
+// 可选的取值，kSizes须与Makefile的DRIVER_SIZES一致
+const char* const kEngines[] = {"original", "softarray", "fence", "pow2", "slotseq"};
+constexpr size_t kSizes[] = {8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096};
+constexpr uint32_t kCapacities[] = {64, 256, 1024, 4096, 16384, 65536};
+constexpr uint32_t kLines[] = {64, 128};
+
+// 运行时的元素大小分派到对应目标文件中的实例，其下再逐级分派容量 -> 缓存行大小 -> 实现
+bool dispatch(const Config& config, const Spec& spec, Result* result) {
+    switch (config.element_size) {
+        case 8: return dispatch_capacity<8>(config, spec, result);
+        case 16: return dispatch_capacity<16>(config, spec, result);
+        case 32: return dispatch_capacity<32>(config, spec, result);
+        case 64: return dispatch_capacity<64>(config, spec, result);
+        case 128: return dispatch_capacity<128>(config, spec, result);
+        case 256: return dispatch_capacity<256>(config, spec, result);
+        case 512: return dispatch_capacity<512>(config, spec, result);
+        case 1024: return dispatch_capacity<1024>(config, spec, result);
+        case 2048: return dispatch_capacity<2048>(config, spec, result);
+        case 4096: return dispatch_capacity<4096>(config, spec, result);
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------- 命令行解析
+
+static void print_usage(const char* program) {
+    std::cerr << "用法: " << program << " [键=值1,值2,...]..." << std::endl;
+    std::cerr << "  engine=    实现: original,softarray,fence,pow2,slotseq 或 all (默认 softarray,pow2)" << std::endl;
+    std::cerr << "  size=      元素字节数: 8,16,32,...,4096 (2的幂) 或 all (默认 8,64)" << std::endl;
+    std::cerr << "  capacity=  容量: 64,256,1024,4096,16384,65536 或 all (默认 1024)" << std::endl;
+    std::cerr << "  line=      缓存行大小: 64,128 或 all (默认 64,128)" << std::endl;
+    std::cerr << "  batch=     每次push_n/pop_n的元素数，1为单元素push/pop (默认 1)" << std::endl;
+    std::cerr << "  pin=       生产者:消费者CPU，none为不绑定，例如 none,0:1,0:2 (默认 none)" << std::endl;
+    std::cerr << "  messages=  每次运行传递的消息数 (默认 1000000)" << std::endl;
+    std::cerr << "  runs=      每个配置记录的运行次数 (默认 5)" << std::endl;
+    std::cerr << "  warmup=    每个配置记录前丢弃的运行次数 (默认 1)" << std::endl;
+    std::cerr << "  format=    table,csv,json (默认 table)" << std::endl;
+    std::cerr << "  output=    输出文件，默认写到标准输出" << std::endl;
+    std::cerr << "  perf=      on,off: 每个线程用perf_event_open统计周期、指令、缓存/分支未命中 (默认 on)" << std::endl;
+    std::cerr << "  hitm_event= HITM的原始事件编码(十六进制)或none (Intel默认 0x04d2，其他厂商默认 none)" << std::endl;
+    std::cerr << "示例: " << program << " engine=all size=8,256,4096 line=all batch=1,32 format=csv output=results.csv"
+              << std::endl;
+}
+
+static std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> parts;
+    std::stringstream stream(text);
+    std::string part;
+    while (std::getline(stream, part, ',')) {
+        if (!part.empty()) {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+static bool parse_number(const std::string& text, uint64_t* value) {
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long const parsed = std::strtoull(text.c_str(), &end, 10);
+    if (text.empty() || errno != 0 || *end != '\0') {
+        return false;
+    }
+    *value = parsed;
+    return true;
+}
+
+// 解析数字列表，allowed非空时只接受其中的值，"all"展开为allowed全部
+template<typename U, size_t N>
+static bool parse_numbers(const std::string& text, const U (&allowed)[N], std::vector<U>* values) {
+    values->clear();
+    if (text == "all") {
+        values->assign(allowed, allowed + N);
+        return true;
+    }
+    for (const std::string& part : split(text)) {
+        uint64_t value;
+        if (!parse_number(part, &value) || std::find(allowed, allowed + N, value) == allowed + N) {
+            return false;
+        }
+        values->push_back(static_cast<U>(value));
+    }
+    return !values->empty();
+}
+
+static bool parse_arguments(int argc, char** argv, Spec* spec) {
+    for (int i = 1; i < argc; ++i) {
+        std::string const argument = argv[i];
+        size_t const equals = argument.find('=');
+        if (equals == std::string::npos) {
+            return false;
+        }
+        std::string const key = argument.substr(0, equals);
+        std::string const value = argument.substr(equals + 1);
+        bool ok = true;
+        uint64_t number = 0;
+
+        if (key == "engine") {
+            spec->engines = value == "all"
+                ? std::vector<std::string>(std::begin(kEngines), std::end(kEngines)) : split(value);
+            for (const std::string& engine : spec->engines) {
+                ok = ok && std::find(std::begin(kEngines), std::end(kEngines), engine) != std::end(kEngines);
+            }
+            ok = ok && !spec->engines.empty();
+        } else if (key == "size") {
+            ok = parse_numbers(value, kSizes, &spec->sizes);
+        } else if (key == "capacity") {
+            ok = parse_numbers(value, kCapacities, &spec->capacities);
+        } else if (key == "line") {
+            ok = parse_numbers(value, kLines, &spec->lines);
+        } else if (key == "batch") {
+            spec->batches.clear();
+            for (const std::string& part : split(value)) {
+                ok = ok && parse_number(part, &number) && number >= 1;
+                spec->batches.push_back(static_cast<size_t>(number));
+            }
+            ok = ok && !spec->batches.empty();
+        } else if (key == "pin") {
+            spec->pins.clear();
+            for (const std::string& part : split(value)) {
+                if (part == "none") {
+                    spec->pins.push_back({-1, -1});
+                    continue;
+                }
+                size_t const colon = part.find(':');
+                uint64_t producer = 0;
+                uint64_t consumer = 0;
+                ok = ok && colon != std::string::npos
+                    && parse_number(part.substr(0, colon), &producer)
+                    && parse_number(part.substr(colon + 1), &consumer)
+                    && producer < CPU_SETSIZE && consumer < CPU_SETSIZE;
+                spec->pins.push_back({static_cast<int>(producer), static_cast<int>(consumer)});
+            }
+            ok = ok && !spec->pins.empty();
+        } else if (key == "messages") {
+            ok = parse_number(value, &number) && number >= 1;
+            spec->messages = number;
+        } else if (key == "runs") {
+            ok = parse_number(value, &number) && number >= 1;
+            spec->runs = static_cast<int>(number);
+        } else if (key == "warmup") {
+            ok = parse_number(value, &number);
+            spec->warmup = static_cast<int>(number);
+        } else if (key == "format") {
+            spec->format = value;
+            ok = value == "table" || value == "csv" || value == "json";
+        } else if (key == "output") {
+            spec->output = value;
+        } else if (key == "perf") {
+            spec->perf = value == "on";
+            ok = value == "on" || value == "off";
+        } else if (key == "hitm_event") {
+            char* end = nullptr;
+            spec->hitm_config = value == "none" ? 0 : std::strtoull(value.c_str(), &end, 16);
+            ok = value == "none" || (!value.empty() && *end == '\0');
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "无效的参数: " << argument << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 展开所有维度的组合；original不区分缓存行大小，只测一次
+static std::vector<Config> expand(const Spec& spec) {
+    std::vector<Config> configs;
+    for (const std::string& engine : spec.engines) {
+        std::vector<uint32_t> const lines = engine == "original" ? std::vector<uint32_t>{0} : spec.lines;
+        for (size_t size : spec.sizes) {
+            for (uint32_t capacity : spec.capacities) {
+                for (uint32_t line : lines) {
+                    for (size_t batch : spec.batches) {
+                        for (const CpuPair& pin : spec.pins) {
+                            configs.push_back({engine, size, capacity, line, batch, pin});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return configs;
+}
+
+// ---------------------------------------------------------------- 输出
+
+static std::string pin_label(const CpuPair& pin) {
+    if (pin.producer < 0) {
+        return "none";
+    }
+    return std::to_string(pin.producer) + ":" + std::to_string(pin.consumer);
+}
+
+// 计数器不可用(NaN)时输出"-"
+static std::string format_count(double value, int precision) {
+    if (std::isnan(value)) {
+        return "-";
+    }
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(precision) << value;
+    return text.str();
+}
+
+static void write_table(std::ostream& out, const std::vector<Result>& results) {
+    out << "     实现 |  大小 |  容量 |  行 | 批量 |   绑定 | 次数 |  平均(msg/s) |  中位(msg/s) | 标准差 |       最小 |       最大 |    MB/s | 校验"
+        << std::endl;
+    out << "----------|-------|-------|-----|------|--------|------|--------------|--------------|--------|------------|------------|---------|-----"
+        << std::endl;
+    for (const Result& r : results) {
+        const Config& c = r.config;
+        out << std::setw(9) << c.engine << " | "
+            << std::setw(5) << c.element_size << " | "
+            << std::setw(5) << c.capacity << " | "
+            << std::setw(3) << (c.line ? std::to_string(c.line) : "-") << " | "
+            << std::setw(4) << c.batch << " | "
+            << std::setw(6) << (pin_label(c.pin) + (r.pinned ? "" : "!")) << " | "
+            << std::setw(4) << r.samples.size() << " | "
+            << std::fixed << std::setprecision(0)
+            << std::setw(12) << r.mean() << " | "
+            << std::setw(12) << r.median() << " | "
+            << std::setprecision(1) << std::setw(5) << r.stddev() / r.mean() * 100 << "% | "
+            << std::setprecision(0)
+            << std::setw(10) << r.min() << " | "
+            << std::setw(10) << r.max() << " | "
+            << std::setprecision(1) << std::setw(7) << r.mean() * c.element_size / 1e6 << " | "
+            << (r.verified ? "✓" : "✗") << std::endl;
+    }
+    out << "绑定列带!表示设置CPU亲和性失败，该配置按不绑定运行" << std::endl;
+
+    bool counted = false;
+    for (const Result& r : results) {
+        counted = counted || r.producer_counts.any() || r.consumer_counts.any();
+    }
+    if (!counted) {
+        return;
+    }
+    out << "\n硬件计数器 (每条消息；P=生产者线程，C=消费者线程，-为不可用)" << std::endl;
+    out << "     实现 |  大小 |  容量 |  行 | 批量 |"
+        << "  P周期 | P IPC |  P L1D |  P LLC |  P分支 | P HITM |"
+        << "  C周期 | C IPC |  C L1D |  C LLC |  C分支 | C HITM" << std::endl;
+    out << "----------|-------|-------|-----|------|"
+        << "--------|-------|--------|--------|--------|--------|"
+        << "--------|-------|--------|--------|--------|-------" << std::endl;
+    for (const Result& r : results) {
+        const Config& c = r.config;
+        out << std::setw(9) << c.engine << " | "
+            << std::setw(5) << c.element_size << " | "
+            << std::setw(5) << c.capacity << " | "
+            << std::setw(3) << (c.line ? std::to_string(c.line) : "-") << " | "
+            << std::setw(4) << c.batch << " |";
+        for (const ChanPerf::Counts* counts : {&r.producer_counts, &r.consumer_counts}) {
+            double const cycles = r.per_message(*counts, ChanPerf::kCycles);
+            double const instructions = r.per_message(*counts, ChanPerf::kInstructions);
+            out << ' ' << std::setw(6) << format_count(cycles, 1) << " |"
+                << ' ' << std::setw(5) << format_count(instructions / cycles, 2) << " |"
+                << ' ' << std::setw(6) << format_count(r.per_message(*counts, ChanPerf::kL1dMisses), 3) << " |"
+                << ' ' << std::setw(6) << format_count(r.per_message(*counts, ChanPerf::kLlcMisses), 3) << " |"
+                << ' ' << std::setw(6) << format_count(r.per_message(*counts, ChanPerf::kBranchMisses), 3) << " |"
+                << ' ' << std::setw(6) << format_count(r.per_message(*counts, ChanPerf::kHitm), 3)
+                << (counts == &r.producer_counts ? " |" : "");
+        }
+        out << std::endl;
+    }
+}
+
+static const char* const kCsvColumns =
+    "engine,element_size,capacity,cache_line,batch,producer_cpu,consumer_cpu,pinned,messages,runs,"
+    "mean_msgs_per_sec,median_msgs_per_sec,stddev_msgs_per_sec,min_msgs_per_sec,max_msgs_per_sec,"
+    "mean_ns_per_msg,mean_mb_per_sec,verified,samples";
+
+// 计数器列: producer_cycles_per_msg, ..., consumer_hitm_per_msg，不可用时留空
+static void write_counter_columns(std::ostream& out) {
+    for (const char* side : {"producer", "consumer"}) {
+        for (int i = 0; i < ChanPerf::kCounterCount; ++i) {
+            out << ',' << side << '_' << ChanPerf::counter_name(i) << "_per_msg";
+        }
+    }
+}
+
+static void write_csv(std::ostream& out, const std::vector<Result>& results, const Spec& spec) {
+    out << kCsvColumns;
+    write_counter_columns(out);
+    out << "\n";
+    out << std::fixed << std::setprecision(1);
+    for (const Result& r : results) {
+        const Config& c = r.config;
+        out << c.engine << ',' << c.element_size << ',' << c.capacity << ',' << c.line << ','
+            << c.batch << ',' << c.pin.producer << ',' << c.pin.consumer << ','
+            << (r.pinned ? 1 : 0) << ',' << spec.messages << ',' << r.samples.size() << ','
+            << r.mean() << ',' << r.median() << ',' << r.stddev() << ',' << r.min() << ',' << r.max() << ','
+            << std::setprecision(3) << 1e9 / r.mean() << ',' << r.mean() * c.element_size / 1e6 << ','
+            << std::setprecision(1) << (r.verified ? 1 : 0) << ',';
+        // 每次运行的吞吐量，分号分隔
+        for (size_t i = 0; i < r.samples.size(); ++i) {
+            out << (i ? ";" : "") << r.samples[i];
+        }
+        out << std::setprecision(4);
+        for (const ChanPerf::Counts* counts : {&r.producer_counts, &r.consumer_counts}) {
+            for (int i = 0; i < ChanPerf::kCounterCount; ++i) {
+                double const value = r.per_message(*counts, i);
+                out << ',';
+                if (!std::isnan(value)) {
+                    out << value;
+                }
+            }
+        }
+        out << std::setprecision(1) << "\n";
+    }
+}
+
+static void write_json(std::ostream& out, const std::vector<Result>& results, const Spec& spec) {
+    out << std::fixed << std::setprecision(1);
+    out << "{\n";
+    out << "  \"messages\": " << spec.messages << ",\n";
+    out << "  \"runs\": " << spec.runs << ",\n";
+    out << "  \"warmup\": " << spec.warmup << ",\n";
+    out << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"perf_counters\": " << (spec.perf ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        const Config& c = r.config;
+        out << (i ? "," : "") << "\n    {";
+        out << "\"engine\": \"" << c.engine << "\", \"element_size\": " << c.element_size
+            << ", \"capacity\": " << c.capacity << ", \"cache_line\": " << c.line
+            << ", \"batch\": " << c.batch
+            << ", \"producer_cpu\": " << c.pin.producer << ", \"consumer_cpu\": " << c.pin.consumer
+            << ", \"pinned\": " << (r.pinned ? "true" : "false")
+            << ", \"mean_msgs_per_sec\": " << r.mean() << ", \"median_msgs_per_sec\": " << r.median()
+            << ", \"stddev_msgs_per_sec\": " << r.stddev()
+            << ", \"min_msgs_per_sec\": " << r.min() << ", \"max_msgs_per_sec\": " << r.max()
+            << std::setprecision(3)
+            << ", \"mean_ns_per_msg\": " << 1e9 / r.mean()
+            << ", \"mean_mb_per_sec\": " << r.mean() * c.element_size / 1e6
+            << std::setprecision(1)
+            << ", \"verified\": " << (r.verified ? "true" : "false")
+            << ", \"samples\": [";
+        for (size_t j = 0; j < r.samples.size(); ++j) {
+            out << (j ? ", " : "") << r.samples[j];
+        }
+        out << "]" << std::setprecision(4);
+        // 每条消息的计数器值，不可用时为null
+        for (const ChanPerf::Counts* counts : {&r.producer_counts, &r.consumer_counts}) {
+            out << ", \"" << (counts == &r.producer_counts ? "producer" : "consumer") << "_counters\": {";
+            for (int k = 0; k < ChanPerf::kCounterCount; ++k) {
+                double const value = r.per_message(*counts, k);
+                out << (k ? ", " : "") << '"' << ChanPerf::counter_name(k) << "_per_msg\": ";
+                if (std::isnan(value)) {
+                    out << "null";
+                } else {
+                    out << value;
+                }
+            }
+            out << "}";
+        }
+        out << std::setprecision(1) << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// 先在主线程上试开一次计数器组：整组不可用时关闭perf，部分不可用时列出缺少的计数器
+static void probe_counters(Spec* spec) {
+    ChanPerf::CounterGroup probe(spec->hitm_config);
+    if (!probe.available()) {
+        std::cerr << "硬件计数器不可用 (" << std::strerror(probe.error()) << ")，只报告吞吐量；"
+                  << "容器中需要CAP_PERFMON，或kernel.perf_event_paranoid不高于2" << std::endl;
+        spec->perf = false;
+        return;
+    }
+    probe.start();
+    probe.stop();
+    ChanPerf::Counts const counts = probe.read();
+    std::string missing;
+    for (int i = 0; i < ChanPerf::kCounterCount; ++i) {
+        if (!counts.present[i]) {
+            missing += std::string(missing.empty() ? "" : ",") + ChanPerf::counter_name(i);
+        }
+    }
+    if (!missing.empty()) {
+        std::cerr << "以下计数器不可用，结果中留空: " << missing << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    Spec spec;
+    spec.hitm_config = ChanPerf::default_hitm_config();
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+    }
+    if (!parse_arguments(argc, argv, &spec)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (std::thread::hardware_concurrency() < 2) {
+        ChanStats::yield_when_idle = true;
+    }
+    if (spec.perf) {
+        probe_counters(&spec);
+    }
+
+    std::vector<Config> const configs = expand(spec);
+    std::vector<Result> results;
+    // 进度写到标准错误，不影响重定向的CSV/JSON
+    for (size_t i = 0; i < configs.size(); ++i) {
+        const Config& c = configs[i];
+        std::cerr << "[" << i + 1 << "/" << configs.size() << "] " << c.engine
+                  << " size=" << c.element_size << " capacity=" << c.capacity
+                  << " line=" << c.line << " batch=" << c.batch << " pin=" << pin_label(c.pin);
+        Result result;
+        result.config = c;
+        if (!dispatch(c, spec, &result)) {
+            std::cerr << " 跳过 (不支持批量接口)" << std::endl;
+            continue;
+        }
+        std::cerr << std::fixed << std::setprecision(0) << " " << result.mean() << " msg/s" << std::endl;
+        results.push_back(std::move(result));
+    }
+
+    std::ofstream file;
+    if (!spec.output.empty()) {
+        file.open(spec.output);
+        if (!file) {
+            std::cerr << "无法打开输出文件: " << spec.output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = spec.output.empty() ? std::cout : file;
+    if (spec.format == "csv") {
+        write_csv(out, results, spec);
+    } else if (spec.format == "json") {
+        write_json(out, results, spec);
+    } else {
+        write_table(out, results);
+    }
+    return 0;
+}
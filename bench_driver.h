@@ -0,0 +1,96 @@
+#ifndef _PERF_TEST_BENCH_DRIVER_H_
+#define _PERF_TEST_BENCH_DRIVER_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "chan_perf.h"
+
+// bench_driver的命令行解析/输出(bench_driver.cc)与各元素大小的模板实例
+// (bench_driver_dispatch.cc，每种大小单独编译一个目标文件)之间共享的类型
+
+struct CpuPair {
+    int producer;   // -1表示不绑定
+    int consumer;
+};
+
+// 命令行参数
+struct Spec {
+    std::vector<std::string> engines{"softarray", "pow2"};
+    std::vector<size_t> sizes{8, 64};
+    std::vector<uint32_t> capacities{1024};
+    std::vector<uint32_t> lines{64, 128};
+    std::vector<size_t> batches{1};
+    std::vector<CpuPair> pins{{-1, -1}};
+    uint64_t messages = 1000000;
+    int runs = 5;
+    int warmup = 1;
+    std::string format = "table";
+    std::string output;
+    bool perf = true;               // 是否打开硬件计数器
+    uint64_t hitm_config = 0;       // HITM的原始事件编码，0为不打开
+};
+
+// 一个待测配置
+struct Config {
+    std::string engine;
+    size_t element_size;
+    uint32_t capacity;
+    uint32_t line;          // original不区分缓存行大小，记为0
+    size_t batch;
+    CpuPair pin;
+};
+
+// 一个配置多次运行的结果
+struct Result {
+    Config config;
+    std::vector<double> samples;   // 每次运行的吞吐量，msgs/sec
+    bool pinned = true;
+    bool verified = true;
+    // 所有记录运行中生产者/消费者线程的计数器累计值
+    ChanPerf::Counts producer_counts;
+    ChanPerf::Counts consumer_counts;
+    uint64_t counted_messages = 0;
+
+    double mean() const {
+        double sum = 0;
+        for (double s : samples) sum += s;
+        return sum / samples.size();
+    }
+
+    double stddev() const {
+        if (samples.size() < 2) return 0.0;
+        double const m = mean();
+        double sum = 0;
+        for (double s : samples) sum += (s - m) * (s - m);
+        return std::sqrt(sum / (samples.size() - 1));
+    }
+
+    double median() const {
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t const n = sorted.size();
+        return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    }
+
+    double min() const { return *std::min_element(samples.begin(), samples.end()); }
+    double max() const { return *std::max_element(samples.begin(), samples.end()); }
+
+    // 每条消息的计数，计数器不可用时为NaN
+    double per_message(const ChanPerf::Counts& counts, int counter) const {
+        if (!counts.present[counter] || counted_messages == 0) {
+            return std::nan("");
+        }
+        return counts.value[counter] / counted_messages;
+    }
+};
+
+// 按容量、缓存行大小和实现分派到模板实例并测量；不支持的组合返回false。
+// 只在bench_driver_dispatch.cc中定义，并按Makefile的DRIVER_SIZES显式实例化
+template<size_t Bytes>
+bool dispatch_capacity(const Config& config, const Spec& spec, Result* result);
+
+#endif  // _PERF_TEST_BENCH_DRIVER_H_
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "chan.h"
+#include "chan_soft_array.h"
+#include "chan_fence.h"
+#include "chan_pow2.h"
+#include "chan_slot_seq.h"
+#include "chan_clock.h"
+#include "chan_perf.h"
+#include "chan_stats.h"
+#include "bench_driver.h"
+
+// bench_driver的测量部分：一个元素大小展开为 容量 x 缓存行大小 x 实现 共48个队列类型，
+// 全放在一个编译单元里编译要几分钟。Makefile按DRIVER_SIZES把本文件编译多次，
+// 每次用-DBENCH_DRIVER_SIZE只实例化一种元素大小，make -j时并行编译
+#ifndef BENCH_DRIVER_SIZE
+#error "用 -DBENCH_DRIVER_SIZE=<元素字节数> 编译，见Makefile中的DRIVER_SIZES"
+#endif
+
+// 元素：首8字节为序号，用于校验，其余填充到指定大小
+template<size_t Bytes>
+struct Payload {
+    static_assert(Bytes > sizeof(uint64_t), "Payload must be larger than its sequence");
+    uint64_t sequence;
+    unsigned char bytes[Bytes - sizeof(uint64_t)];
+};
+
+template<>
+struct Payload<sizeof(uint64_t)> {
+    uint64_t sequence;
+};
+
+// 队列是否提供push_n/pop_n
+template<typename Queue, typename = void>
+struct HasBatch : std::false_type {};
+
+template<typename Queue>
+struct HasBatch<Queue, std::void_t<decltype(std::declval<Queue&>().push_n(nullptr, 0))>>
+    : std::true_type {};
+
+// 原始实现是普通对象，容量在运行时指定；其余实现用create()/destroy()
+template<typename Queue>
+struct Factory {
+    static Queue* create(uint32_t) { return Queue::create(); }
+    static void destroy(Queue* queue) { Queue::destroy(queue); }
+};
+
+template<typename T>
+struct Factory<SPSCQueue<T>> {
+    static SPSCQueue<T>* create(uint32_t capacity) { return new SPSCQueue<T>(capacity - 1); }
+    static void destroy(SPSCQueue<T>* queue) { delete queue; }
+};
+
+// 生产者：batch大于1且队列有push_n时整批写入，否则逐个push
+template<typename P, typename Queue>
+void produce(Queue* queue, const Config& config, uint64_t messages) {
+    if constexpr (HasBatch<Queue>::value) {
+        if (config.batch > 1) {
+            std::vector<P> batch(config.batch);
+            for (uint64_t sent = 0; sent < messages;) {
+                size_t const n = static_cast<size_t>(std::min<uint64_t>(config.batch, messages - sent));
+                for (size_t i = 0; i < n; ++i) {
+                    batch[i].sequence = sent + i;
+                }
+                for (size_t done = 0; done < n;) {
+                    size_t const pushed = queue->push_n(batch.data() + done, n - done);
+                    if (pushed == 0) {
+                        ChanStats::idle();
+                    }
+                    done += pushed;
+                }
+                sent += n;
+            }
+            return;
+        }
+    }
+    P item{};
+    for (uint64_t i = 0; i < messages; ++i) {
+        item.sequence = i;
+        queue->push(item);
+    }
+}
+
+// 消费者：逐条比对序号，返回与期望顺序不符的消息数(丢失、重复和乱序都会计入)
+template<typename P, typename Queue>
+uint64_t consume(Queue* queue, const Config& config, uint64_t messages) {
+    uint64_t mismatches = 0;
+    if constexpr (HasBatch<Queue>::value) {
+        if (config.batch > 1) {
+            std::vector<P> batch(config.batch);
+            for (uint64_t received = 0; received < messages;) {
+                size_t const want = static_cast<size_t>(std::min<uint64_t>(config.batch, messages - received));
+                size_t const n = queue->pop_n(batch.data(), want);
+                if (n == 0) {
+                    ChanStats::idle();
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    mismatches += batch[i].sequence != received + i;
+                }
+                received += n;
+            }
+            return mismatches;
+        }
+    }
+    for (uint64_t i = 0; i < messages; ++i) {
+        P* item;
+        while (!(item = queue->front())) {
+            ChanStats::idle();
+        }
+        mismatches += item->sequence != i;
+        queue->pop();
+    }
+    return mismatches;
+}
+
+// 在调用线程上执行body，spec.perf开启时用计数器组包住body
+template<typename Body>
+ChanPerf::Counts counted(const Spec& spec, Body body) {
+    if (!spec.perf) {
+        body();
+        return ChanPerf::Counts();
+    }
+    ChanPerf::CounterGroup counters(spec.hitm_config);
+    counters.start();
+    body();
+    counters.stop();
+    return counters.read();
+}
+
+// 运行一次，返回吞吐量；消费者逐条校验序号按顺序到达
+template<typename P, typename Queue>
+double run_once(Queue* queue, const Config& config, const Spec& spec, Result* result) {
+    uint64_t const messages = spec.messages;
+    bool producer_pinned = true;
+    bool consumer_pinned = true;
+    uint64_t mismatches = 0;
+    ChanPerf::Counts producer_counts;
+    ChanPerf::Counts consumer_counts;
+    uint64_t const start = ChanClock::ticks();
+
+    std::thread producer([&]() {
+        producer_pinned = ChanStats::pin_to_cpu(config.pin.producer);
+        producer_counts = counted(spec, [&]() { produce<P>(queue, config, messages); });
+    });
+
+    std::thread consumer([&]() {
+        consumer_pinned = ChanStats::pin_to_cpu(config.pin.consumer);
+        consumer_counts = counted(spec, [&]() { mismatches = consume<P>(queue, config, messages); });
+    });
+
+    producer.join();
+    consumer.join();
+
+    double const elapsed_ns = ChanClock::ticks_to_ns(ChanClock::ticks() - start);
+    result->pinned = result->pinned && producer_pinned && consumer_pinned;
+    result->verified = result->verified && mismatches == 0;
+    result->producer_counts.add(producer_counts);
+    result->consumer_counts.add(consumer_counts);
+    result->counted_messages += messages;
+    return messages * 1e9 / elapsed_ns;
+}
+
+// 测量一个配置：预热若干次后记录spec.runs次；不支持的组合返回false
+template<typename P, typename Queue>
+bool measure(const Config& config, const Spec& spec, Result* result) {
+    if (config.batch > 1 && !HasBatch<Queue>::value) {
+        return false;
+    }
+    Queue* queue = Factory<Queue>::create(config.capacity);
+    if (!queue) {
+        std::cerr << "队列创建失败: " << config.engine << std::endl;
+        exit(1);
+    }
+    for (int i = 0; i < spec.warmup; ++i) {
+        Result discarded;
+        run_once<P>(queue, config, spec, &discarded);
+    }
+    for (int i = 0; i < spec.runs; ++i) {
+        result->samples.push_back(run_once<P>(queue, config, spec, result));
+    }
+    Factory<Queue>::destroy(queue);
+    return true;
+}
+
+// 逐级分派到模板实例：容量 -> 缓存行大小 -> 实现(元素大小由bench_driver.cc的dispatch()分派)
+template<size_t Bytes, uint32_t Capacity, uint32_t Line>
+bool dispatch_engine(const Config& config, const Spec& spec, Result* result) {
+    using P = Payload<Bytes>;
+    if (config.engine == "softarray") {
+        return measure<P, SPSCQueueSoftArray<P, Capacity, Line>>(config, spec, result);
+    } else if (config.engine == "fence") {
+        return measure<P, SPSCQueueFence<P, Capacity, Line>>(config, spec, result);
+    } else if (config.engine == "pow2") {
+        return measure<P, SPSCQueuePow2<P, Capacity, Line>>(config, spec, result);
+    } else if (config.engine == "slotseq") {
+        return measure<P, SPSCQueueSlotSeq<P, Capacity, Line>>(config, spec, result);
+    }
+    return false;
+}
+
+template<size_t Bytes, uint32_t Capacity>
+bool dispatch_line(const Config& config, const Spec& spec, Result* result) {
+    switch (config.line) {
+        case 64: return dispatch_engine<Bytes, Capacity, 64>(config, spec, result);
+        case 128: return dispatch_engine<Bytes, Capacity, 128>(config, spec, result);
+    }
+    return false;
+}
+
+template<size_t Bytes>
+bool dispatch_capacity(const Config& config, const Spec& spec, Result* result) {
+    if (config.engine == "original") {
+        return measure<Payload<Bytes>, SPSCQueue<Payload<Bytes>>>(config, spec, result);
+    }
+    switch (config.capacity) {
+        case 64: return dispatch_line<Bytes, 64>(config, spec, result);
+        case 256: return dispatch_line<Bytes, 256>(config, spec, result);
+        case 1024: return dispatch_line<Bytes, 1024>(config, spec, result);
+        case 4096: return dispatch_line<Bytes, 4096>(config, spec, result);
+        case 16384: return dispatch_line<Bytes, 16384>(config, spec, result);
+        case 65536: return dispatch_line<Bytes, 65536>(config, spec, result);
+    }
+    return false;
+}
+
+template bool dispatch_capacity<BENCH_DRIVER_SIZE>(const Config& config, const Spec& spec, Result* result);
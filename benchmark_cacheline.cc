@@ -6,11 +6,14 @@
 #include <numeric>
 #include <cmath>
 #include "chan_soft_array.h"
+#include "chan_pow2.h"
 
 // 测试参数
 constexpr int TEST_COUNT = 1000000;  // 测试次数
 constexpr int WARMUP_COUNT = 100000; // 预热次数
 constexpr int BENCHMARK_RUNS = 5;    // 基准测试运行次数
+constexpr size_t BATCH_SIZES[] = {1, 32, 64, 128, 256, 512}; // 批量测试的批大小
+constexpr uint32_t DEFERRED_INTERVALS[] = {1, 4, 16, 64};    // 延迟发布测试的发布间隔
 
 // 定义不同缓存行大小的类型别名
 using Queue32 = SPSCQueueSoftArray<int, 1024, 32>;
@@ -18,6 +21,10 @@ using Queue64 = SPSCQueueSoftArray<int, 1024, 64>;
 using Queue128 = SPSCQueueSoftArray<int, 1024, 128>;
 using Queue256 = SPSCQueueSoftArray<int, 1024, 256>;
 
+// 2的幂容量 + 64位单调序号的实现，与取模回绕的实现对比
+using QueuePow2_64 = SPSCQueuePow2<int, 1024, 64>;
+using QueuePow2_128 = SPSCQueuePow2<int, 1024, 128>;
+
 template<typename QueueType>
 double single_throughput_test(QueueType* queue) {
     // 预热
@@ -70,6 +77,131 @@ double single_throughput_test(QueueType* queue) {
     return (double)TEST_COUNT * 1000000.0 / duration.count();
 }
 
+// 批量版本：生产者用push_n，消费者用pop_n，每批只发布一次索引
+template<typename QueueType>
+double single_batched_throughput_test(QueueType* queue, size_t batch) {
+    auto run = [queue, batch](int count) {
+        std::thread producer([queue, batch, count]() {
+            std::vector<int> items(batch);
+            int sent = 0;
+            while (sent < count) {
+                size_t todo = std::min<size_t>(batch, count - sent);
+                for (size_t i = 0; i < todo; ++i) {
+                    items[i] = sent + static_cast<int>(i);
+                }
+                size_t done = 0;
+                while (done < todo) {
+                    done += queue->push_n(items.data() + done, todo - done);
+                }
+                sent += static_cast<int>(todo);
+            }
+        });
+        
+        std::thread consumer([queue, batch, count]() {
+            std::vector<int> items(batch);
+            int consumed = 0;
+            while (consumed < count) {
+                consumed += static_cast<int>(queue->pop_n(items.data(), batch));
+            }
+        });
+        
+        producer.join();
+        consumer.join();
+    };
+    
+    // 预热
+    run(WARMUP_COUNT);
+    
+    // 正式测试
+    auto start_time = std::chrono::high_resolution_clock::now();
+    run(TEST_COUNT);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    return (double)TEST_COUNT * 1000000.0 / duration.count();
+}
+
+template<typename QueueType>
+void benchmark_batched_throughput(QueueType* queue, const std::string& name) {
+    std::cout << "\n批量基准测试 - 缓存行大小: " << name << std::endl;
+    std::cout << "  批大小 |  中位数吞吐量(ops/sec)" << std::endl;
+    
+    for (size_t batch : BATCH_SIZES) {
+        std::vector<double> throughputs;
+        throughputs.reserve(BENCHMARK_RUNS);
+        for (int run = 0; run < BENCHMARK_RUNS; ++run) {
+            throughputs.push_back(single_batched_throughput_test(queue, batch));
+        }
+        std::sort(throughputs.begin(), throughputs.end());
+        std::cout << "  " << std::setw(6) << batch << " | " << std::fixed << std::setprecision(0)
+                  << std::setw(20) << throughputs[throughputs.size() / 2] << std::endl;
+    }
+}
+
+// 延迟发布版本：生产者逐个push_deferred，每interval个元素才发布一次head_，
+// 消费者仍然逐个front/pop
+template<typename QueueType>
+double single_deferred_throughput_test(QueueType* queue, uint32_t interval) {
+    queue->set_publish_interval(interval);
+    auto run = [queue](int count) {
+        std::thread producer([queue, count]() {
+            for (int i = 0; i < count; ++i) {
+                queue->push_deferred(i);
+            }
+            queue->flush();
+        });
+        
+        std::thread consumer([queue, count]() {
+            int consumed = 0;
+            while (consumed < count) {
+                auto* item = queue->front();
+                if (item) {
+                    queue->pop();
+                    consumed++;
+                }
+            }
+        });
+        
+        producer.join();
+        consumer.join();
+    };
+    
+    // 预热
+    run(WARMUP_COUNT);
+    
+    // 正式测试
+    auto start_time = std::chrono::high_resolution_clock::now();
+    run(TEST_COUNT);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    queue->set_publish_interval(1);
+    return (double)TEST_COUNT * 1000000.0 / duration.count();
+}
+
+template<typename QueueType>
+void benchmark_deferred_throughput(QueueType* queue, const std::string& name) {
+    std::cout << "\n延迟发布基准测试 - 缓存行大小: " << name << std::endl;
+    std::cout << "  发布间隔 |  中位数吞吐量(ops/sec) | 相对N=1" << std::endl;
+    
+    double baseline = 0;
+    for (uint32_t interval : DEFERRED_INTERVALS) {
+        std::vector<double> throughputs;
+        throughputs.reserve(BENCHMARK_RUNS);
+        for (int run = 0; run < BENCHMARK_RUNS; ++run) {
+            throughputs.push_back(single_deferred_throughput_test(queue, interval));
+        }
+        std::sort(throughputs.begin(), throughputs.end());
+        double median = throughputs[throughputs.size() / 2];
+        if (interval == 1) {
+            baseline = median;
+        }
+        std::cout << "  " << std::setw(8) << interval << " | " << std::fixed << std::setprecision(0)
+                  << std::setw(22) << median << " | " << std::setprecision(2)
+                  << median / baseline << "x" << std::endl;
+    }
+}
+
 template<typename QueueType>
 void benchmark_throughput(QueueType* queue, const std::string& name) {
     std::cout << "\n基准测试 - 缓存行大小: " << name << std::endl;
@@ -136,8 +268,10 @@ int main() {
     auto* queue64 = Queue64::create();
     auto* queue128 = Queue128::create();
     auto* queue256 = Queue256::create();
+    auto* queue_pow2_64 = QueuePow2_64::create();
+    auto* queue_pow2_128 = QueuePow2_128::create();
     
-    if (!queue32 || !queue64 || !queue128 || !queue256) {
+    if (!queue32 || !queue64 || !queue128 || !queue256 || !queue_pow2_64 || !queue_pow2_128) {
         std::cerr << "队列创建失败!" << std::endl;
         return 1;
     }
@@ -149,6 +283,23 @@ int main() {
     benchmark_throughput(queue64, "64字节");
     benchmark_throughput(queue128, "128字节");
     benchmark_throughput(queue256, "256字节");
+    benchmark_throughput(queue_pow2_64, "64字节 (Pow2)");
+    benchmark_throughput(queue_pow2_128, "128字节 (Pow2)");
+    
+    std::cout << "\n=== 批量吞吐量测试 (push_n/pop_n) ===" << std::endl;
+    
+    benchmark_batched_throughput(queue32, "32字节");
+    benchmark_batched_throughput(queue64, "64字节");
+    benchmark_batched_throughput(queue128, "128字节");
+    benchmark_batched_throughput(queue256, "256字节");
+    benchmark_batched_throughput(queue_pow2_64, "64字节 (Pow2)");
+    
+    std::cout << "\n=== 延迟发布head_测试 (push_deferred，每N个元素发布一次) ===" << std::endl;
+    
+    benchmark_deferred_throughput(queue32, "32字节");
+    benchmark_deferred_throughput(queue64, "64字节");
+    benchmark_deferred_throughput(queue128, "128字节");
+    benchmark_deferred_throughput(queue256, "256字节");
     
     // 内存使用情况分析
     std::cout << "\n=== 内存使用分析 ===" << std::endl;
@@ -156,6 +307,8 @@ int main() {
     std::cout << "Queue64 对象大小: " << sizeof(Queue64) << " 字节" << std::endl;
     std::cout << "Queue128 对象大小: " << sizeof(Queue128) << " 字节" << std::endl;
     std::cout << "Queue256 对象大小: " << sizeof(Queue256) << " 字节" << std::endl;
+    std::cout << "QueuePow2_64 对象大小: " << sizeof(QueuePow2_64) << " 字节" << std::endl;
+    std::cout << "QueuePow2_128 对象大小: " << sizeof(QueuePow2_128) << " 字节" << std::endl;
     
     // 总结和建议
     std::cout << "\n=== 总结 ===" << std::endl;
@@ -170,6 +323,8 @@ int main() {
     Queue64::destroy(queue64);
     Queue128::destroy(queue128);
     Queue256::destroy(queue256);
+    QueuePow2_64::destroy(queue_pow2_64);
+    QueuePow2_128::destroy(queue_pow2_128);
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include "chan_bip.h"
+#include "chan_soft_array.h"
+
+// 测试参数
+constexpr int TEST_COUNT = 1000000;          // 每轮消息数
+constexpr size_t MIN_PAYLOAD = 16;
+constexpr size_t MAX_PAYLOAD = 4096;
+constexpr size_t RING_BYTES = 1 << 20;       // 字节环容量
+constexpr uint32_t SLOT_COUNT = 256;         // 定长槽位队列的槽位数(与字节环占用相同的内存)
+constexpr uint32_t POINTER_SLOTS = 1024;     // 指针队列的槽位数
+
+// 定长槽位：必须按最大负载分配，小消息浪费大部分槽位
+struct FixedSlot {
+    uint32_t size;
+    uint8_t data[MAX_PAYLOAD];
+};
+
+// 每条消息单独在堆上分配，队列只传指针
+struct HeapMessage {
+    uint8_t* data;
+    uint32_t size;
+};
+
+using ByteRing = SPSCByteRing<RING_BYTES>;
+using SlotQueue = SPSCQueueSoftArray<FixedSlot, SLOT_COUNT>;
+using PointerQueue = SPSCQueueSoftArray<HeapMessage, POINTER_SLOTS>;
+
+struct PayloadResult {
+    double messages_per_sec;
+    double bytes_per_sec;     // 负载字节吞吐(字节/秒)
+    uint64_t checksum;
+};
+
+// 对数均匀分布的负载长度：16B到4KB之间每个数量级的消息数大致相同
+static std::vector<uint32_t> make_sizes(size_t min_size, size_t max_size) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<double> dist(std::log2(static_cast<double>(min_size)),
+                                                std::log2(static_cast<double>(max_size)));
+    std::vector<uint32_t> sizes(TEST_COUNT);
+    for (auto& size : sizes) {
+        size = static_cast<uint32_t>(std::exp2(dist(rng)));
+    }
+    return sizes;
+}
+
+// 消费者只读首尾字节做校验，避免读取本身成为瓶颈
+static inline uint64_t touch(const uint8_t* data, size_t size) {
+    return data[0] + data[size - 1] + size;
+}
+
+static PayloadResult finish(const std::vector<uint32_t>& sizes, double elapsed_ns, uint64_t checksum) {
+    uint64_t total_bytes = 0;
+    for (uint32_t size : sizes) {
+        total_bytes += size;
+    }
+    return {TEST_COUNT * 1e9 / elapsed_ns, total_bytes * 1e9 / elapsed_ns, checksum};
+}
+
+// 变长字节环：reserve/commit原地写入，peek/release原地读取
+static PayloadResult run_byte_ring(const std::vector<uint32_t>& sizes, const uint8_t* source) {
+    auto* ring = ByteRing::create();
+    uint64_t checksum = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([ring, &sizes, source]() {
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            uint8_t* dst;
+            while (!(dst = ring->reserve(sizes[i]))) {
+                // 忙等待
+            }
+            std::memcpy(dst, source, sizes[i]);
+            ring->commit(sizes[i]);
+        }
+    });
+
+    std::thread consumer([ring, &checksum]() {
+        uint64_t sum = 0;
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            ChanUtil::RingSpan<const uint8_t> record;
+            while ((record = ring->peek()).size == 0) {
+                // 忙等待
+            }
+            sum += touch(record.data, record.size);
+            ring->release();
+        }
+        checksum = sum;
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    ByteRing::destroy(ring);
+    return finish(sizes, std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count(),
+                  checksum);
+}
+
+// 定长槽位队列：reserve/commit原地写入实际长度，但每个槽位占MAX_PAYLOAD字节
+static PayloadResult run_fixed_slots(const std::vector<uint32_t>& sizes, const uint8_t* source) {
+    auto* queue = SlotQueue::create();
+    uint64_t checksum = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([queue, &sizes, source]() {
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            ChanUtil::RingSpans<FixedSlot> spans;
+            while ((spans = queue->reserve(1)).empty()) {
+                // 忙等待
+            }
+            FixedSlot* slot = &spans[0];
+            slot->size = sizes[i];
+            std::memcpy(slot->data, source, sizes[i]);
+            queue->commit(1);
+        }
+    });
+
+    std::thread consumer([queue, &checksum]() {
+        uint64_t sum = 0;
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            FixedSlot* slot;
+            while (!(slot = queue->front())) {
+                // 忙等待
+            }
+            sum += touch(slot->data, slot->size);
+            queue->pop();
+        }
+        checksum = sum;
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    SlotQueue::destroy(queue);
+    return finish(sizes, std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count(),
+                  checksum);
+}
+
+// 指针队列：生产者new、消费者delete，每条消息一次堆分配
+static PayloadResult run_heap_pointers(const std::vector<uint32_t>& sizes, const uint8_t* source) {
+    auto* queue = PointerQueue::create();
+    uint64_t checksum = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([queue, &sizes, source]() {
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            HeapMessage message{new uint8_t[sizes[i]], sizes[i]};
+            std::memcpy(message.data, source, sizes[i]);
+            while (!queue->try_push(message)) {
+                // 忙等待
+            }
+        }
+    });
+
+    std::thread consumer([queue, &checksum]() {
+        uint64_t sum = 0;
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            HeapMessage message;
+            while (!queue->try_pop(message)) {
+                // 忙等待
+            }
+            sum += touch(message.data, message.size);
+            delete[] message.data;
+        }
+        checksum = sum;
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    PointerQueue::destroy(queue);
+    return finish(sizes, std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count(),
+                  checksum);
+}
+
+static void print_result(const char* name, size_t footprint, const PayloadResult& r) {
+    std::cout << std::setw(14) << name << " | "
+              << std::setw(9) << footprint / 1024 << " | "
+              << std::fixed << std::setprecision(0) << std::setw(14) << r.messages_per_sec << " | "
+              << std::setprecision(1) << std::setw(10) << r.bytes_per_sec / (1024.0 * 1024) << " | "
+              << r.checksum << std::endl;
+}
+
+int main() {
+    std::cout << "SPSC 变长字节环(bip-buffer) 基准测试" << std::endl;
+    std::cout << "====================================" << std::endl;
+    std::cout << "每轮消息数: " << TEST_COUNT << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+
+    std::vector<uint8_t> source(MAX_PAYLOAD);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    const std::pair<size_t, size_t> ranges[] = {
+        {MIN_PAYLOAD, 64}, {64, 512}, {512, MAX_PAYLOAD}, {MIN_PAYLOAD, MAX_PAYLOAD}};
+
+    for (const auto& range : ranges) {
+        std::vector<uint32_t> sizes = make_sizes(range.first, range.second);
+        double average = 0;
+        for (uint32_t size : sizes) {
+            average += size;
+        }
+        average /= sizes.size();
+
+        std::cout << "\n负载长度: " << range.first << "B - " << range.second << "B (对数均匀分布，平均 "
+                  << std::fixed << std::setprecision(0) << average << "B)" << std::endl;
+        std::cout << "          队列 | 内存(KB) |   消息数/秒    | 负载MB/秒  | 校验和" << std::endl;
+        std::cout << "---------------|-----------|----------------|------------|--------" << std::endl;
+
+        print_result("byte-ring", sizeof(ByteRing), run_byte_ring(sizes, source.data()));
+        print_result("fixed-slot", sizeof(FixedSlot) * SLOT_COUNT, run_fixed_slots(sizes, source.data()));
+        print_result("heap-pointer", sizeof(HeapMessage) * POINTER_SLOTS, run_heap_pointers(sizes, source.data()));
+    }
+
+    std::cout << "\n说明:" << std::endl;
+    std::cout << "• byte-ring 按实际长度占用空间，相同内存下能缓存的消息数远多于定长槽位" << std::endl;
+    std::cout << "• fixed-slot 每个槽位按最大负载分配，小消息时绝大部分内存和缓存行被浪费" << std::endl;
+    std::cout << "• heap-pointer 队列本身很小，但每条消息多一次new/delete和一次指针追踪" << std::endl;
+    std::cout << "• 三者的校验和应当相同" << std::endl;
+
+    return 0;
+}
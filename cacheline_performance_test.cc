@@ -4,6 +4,8 @@
 #include <vector>
 #include <iomanip>
 #include "chan_soft_array.h"
+#include "chan_pow2.h"
+#include "chan_fence.h"
 
 // 测试参数
 constexpr int TEST_COUNT = 1000000;  // 测试次数
@@ -15,6 +17,30 @@ using Queue64 = SPSCQueueSoftArray<int, 1024, 64>;
 using Queue128 = SPSCQueueSoftArray<int, 1024, 128>;
 using Queue256 = SPSCQueueSoftArray<int, 1024, 256>;
 
+// 2的幂容量 + 64位单调序号的实现，与取模回绕的实现对比
+using QueuePow2_64 = SPSCQueuePow2<int, 1024, 64>;
+using QueuePow2_128 = SPSCQueuePow2<int, 1024, 128>;
+
+// 槽位布局对比(见chan_layout.h)：紧凑布局即Queue64，每行16个int
+using QueueGrouped4 = SPSCQueueSoftArray<int, 1024, 64, SpinWait, ChanLayout::SlotGrouped<4>>;
+using QueuePadded = SPSCQueueSoftArray<int, 1024, 64, SpinWait, ChanLayout::SlotPadded>;
+
+// 索引布局对比(见chan_layout.h)：分离布局即Queue64
+using QueueOwnerLine = SPSCQueueSoftArray<int, 1024, 64, SpinWait, ChanLayout::SlotCompact,
+                                          ChanLayout::IndexOwnerLine>;
+using QueueDoubleLine = SPSCQueueSoftArray<int, 1024, 64, SpinWait, ChanLayout::SlotCompact,
+                                           ChanLayout::IndexDoubleLine>;
+using FenceSeparate = SPSCQueueFence<int, 1024, 64>;
+using FenceOwnerLine = SPSCQueueFence<int, 1024, 64, SpinWait, ChanLayout::IndexOwnerLine>;
+using FenceDoubleLine = SPSCQueueFence<int, 1024, 64, SpinWait, ChanLayout::IndexDoubleLine>;
+
+// 冷/热启动对比用的大环：64字节槽位 x 64K = 4MB，第一圈会跨越1024个4KB页
+struct StartupSlot {
+    int64_t value;
+    char payload[56];
+};
+using StartupQueue = SPSCQueueSoftArray<StartupSlot, 1 << 16, 64>;
+
 template<typename QueueType>
 void producer_consumer_test(QueueType* queue, const std::string& name) {
     std::cout << "\n测试缓存行大小: " << name << std::endl;
@@ -74,6 +100,39 @@ void producer_consumer_test(QueueType* queue, const std::string& name) {
               << (double)duration.count() / TEST_COUNT << " 微秒" << std::endl;
 }
 
+// 按行发布：生产者push_deferred，消费者pop_deferred，
+// 分组布局下写满/读完一行才发布索引，两端不会同时访问同一个数据行
+template<typename QueueType>
+void line_publish_test(QueueType* queue, const std::string& name) {
+    std::cout << "\n按行发布测试: " << name << " (发布间隔 " << queue->publish_interval() << ")" << std::endl;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread test_producer([queue]() {
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            queue->push_deferred(i);
+        }
+        queue->flush();
+    });
+
+    std::thread test_consumer([queue]() {
+        int value;
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            queue->pop_deferred(value);
+        }
+        queue->flush_tail();
+    });
+
+    test_producer.join();
+    test_consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+
+    std::cout << "  吞吐量: " << std::fixed << std::setprecision(0)
+              << (double)TEST_COUNT * 1000000.0 / duration.count() << " ops/sec" << std::endl;
+}
+
 template<typename QueueType>
 void latency_test(QueueType* queue, const std::string& name) {
     std::cout << "\n延迟测试 - 缓存行大小: " << name << std::endl;
@@ -110,6 +169,55 @@ void latency_test(QueueType* queue, const std::string& name) {
               << latencies[latencies.size() * 99 / 100] << " 纳秒" << std::endl;
 }
 
+// 新建队列后第一圈的单次push+pop延迟：冷启动时每进入一个新页都要缺页
+void startup_latency_test(const std::string& name, const ChanAlloc::Options& options, bool warm) {
+    auto* queue = StartupQueue::create(options);
+    if (!queue) {
+        std::cerr << "队列创建失败!" << std::endl;
+        return;
+    }
+    if (warm) {
+        queue->warm_producer();
+        queue->warm_consumer();
+    }
+
+    const int lap = queue->capacity() - 1;
+    std::vector<double> latencies;
+    latencies.reserve(lap);
+
+    for (int i = 0; i < lap; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+
+        queue->push(StartupSlot{i, {}});
+        auto* item = queue->front();
+        if (item) {
+            queue->pop();
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double avg = 0;
+    for (auto lat : latencies) {
+        avg += lat;
+    }
+    avg /= latencies.size();
+
+    std::cout << std::setw(22) << name << " | "
+              << std::setw(6) << (queue->prefaulted() ? "是" : "否") << " | "
+              << std::setw(6) << (queue->locked() ? "是" : "否") << " | "
+              << std::fixed << std::setprecision(1)
+              << std::setw(8) << avg << " | "
+              << std::setw(8) << latencies[latencies.size() / 2] << " | "
+              << std::setw(8) << latencies[latencies.size() * 99 / 100] << " | "
+              << std::setw(9) << latencies[latencies.size() * 999 / 1000] << " | "
+              << std::setw(9) << latencies.back() << std::endl;
+
+    StartupQueue::destroy(queue);
+}
+
 int main() {
     std::cout << "SPSC 队列缓存行大小性能测试" << std::endl;
     std::cout << "=================================" << std::endl;
@@ -121,8 +229,19 @@ int main() {
     auto* queue64 = Queue64::create();
     auto* queue128 = Queue128::create();
     auto* queue256 = Queue256::create();
+    auto* queue_pow2_64 = QueuePow2_64::create();
+    auto* queue_pow2_128 = QueuePow2_128::create();
+    auto* queue_grouped4 = QueueGrouped4::create();
+    auto* queue_padded = QueuePadded::create();
+    auto* queue_owner_line = QueueOwnerLine::create();
+    auto* queue_double_line = QueueDoubleLine::create();
+    auto* fence_separate = FenceSeparate::create();
+    auto* fence_owner_line = FenceOwnerLine::create();
+    auto* fence_double_line = FenceDoubleLine::create();
     
-    if (!queue32 || !queue64 || !queue128 || !queue256) {
+    if (!queue32 || !queue64 || !queue128 || !queue256 || !queue_pow2_64 || !queue_pow2_128 ||
+        !queue_grouped4 || !queue_padded || !queue_owner_line || !queue_double_line ||
+        !fence_separate || !fence_owner_line || !fence_double_line) {
         std::cerr << "队列创建失败!" << std::endl;
         return 1;
     }
@@ -134,6 +253,8 @@ int main() {
     producer_consumer_test(queue64, "64字节");
     producer_consumer_test(queue128, "128字节");
     producer_consumer_test(queue256, "256字节");
+    producer_consumer_test(queue_pow2_64, "64字节 (Pow2)");
+    producer_consumer_test(queue_pow2_128, "128字节 (Pow2)");
     
     std::cout << "\n=== 延迟测试 ===" << std::endl;
     
@@ -142,6 +263,47 @@ int main() {
     latency_test(queue64, "64字节");
     latency_test(queue128, "128字节");
     latency_test(queue256, "256字节");
+    latency_test(queue_pow2_64, "64字节 (Pow2)");
+    latency_test(queue_pow2_128, "128字节 (Pow2)");
+
+    std::cout << "\n=== 槽位布局对比 (int, 64字节缓存行) ===" << std::endl;
+    producer_consumer_test(queue64, "SlotCompact (每行16个)");
+    producer_consumer_test(queue_grouped4, "SlotGrouped<4> (每行4个)");
+    producer_consumer_test(queue_padded, "SlotPadded (每行1个)");
+    latency_test(queue64, "SlotCompact (每行16个)");
+    latency_test(queue_grouped4, "SlotGrouped<4> (每行4个)");
+    latency_test(queue_padded, "SlotPadded (每行1个)");
+    line_publish_test(queue64, "SlotCompact");
+    line_publish_test(queue_grouped4, "SlotGrouped<4>");
+
+    std::cout << "\n=== 索引布局对比 (int, 64字节缓存行) ===" << std::endl;
+    producer_consumer_test(queue64, "SoftArray IndexSeparate");
+    producer_consumer_test(queue_owner_line, "SoftArray IndexOwnerLine");
+    producer_consumer_test(queue_double_line, "SoftArray IndexDoubleLine");
+    producer_consumer_test(fence_separate, "Fence IndexSeparate");
+    producer_consumer_test(fence_owner_line, "Fence IndexOwnerLine");
+    producer_consumer_test(fence_double_line, "Fence IndexDoubleLine");
+    latency_test(queue64, "SoftArray IndexSeparate");
+    latency_test(queue_owner_line, "SoftArray IndexOwnerLine");
+    latency_test(queue_double_line, "SoftArray IndexDoubleLine");
+    latency_test(fence_separate, "Fence IndexSeparate");
+    latency_test(fence_owner_line, "Fence IndexOwnerLine");
+    latency_test(fence_double_line, "Fence IndexDoubleLine");
+
+    std::cout << "\n=== 冷启动 vs 预热启动 (新建 " << sizeof(StartupQueue) / 1024
+              << "KB 队列后第一圈的push+pop延迟，单位纳秒) ===" << std::endl;
+    std::cout << "                  启动方式 | 预缺页 |  mlock |     平均 |   中位数 |      p99 |    p99.9 |      最大" << std::endl;
+
+    ChanAlloc::Options cold_options;
+    ChanAlloc::Options prefault_options;
+    prefault_options.prefault = true;
+    ChanAlloc::Options warm_options;
+    warm_options.prefault = true;
+    warm_options.lock_memory = true;
+
+    startup_latency_test("冷启动", cold_options, false);
+    startup_latency_test("预缺页", prefault_options, false);
+    startup_latency_test("预缺页+mlock+预热索引", warm_options, true);
     
     // 内存使用情况分析
     std::cout << "\n=== 内存使用分析 ===" << std::endl;
@@ -149,12 +311,27 @@ int main() {
     std::cout << "Queue64 对象大小: " << sizeof(Queue64) << " 字节" << std::endl;
     std::cout << "Queue128 对象大小: " << sizeof(Queue128) << " 字节" << std::endl;
     std::cout << "Queue256 对象大小: " << sizeof(Queue256) << " 字节" << std::endl;
+    std::cout << "QueuePow2_64 对象大小: " << sizeof(QueuePow2_64) << " 字节" << std::endl;
+    std::cout << "QueuePow2_128 对象大小: " << sizeof(QueuePow2_128) << " 字节" << std::endl;
+    std::cout << "QueueGrouped4 对象大小: " << sizeof(QueueGrouped4) << " 字节" << std::endl;
+    std::cout << "QueuePadded 对象大小: " << sizeof(QueuePadded) << " 字节" << std::endl;
+    std::cout << "QueueOwnerLine 对象大小: " << sizeof(QueueOwnerLine) << " 字节" << std::endl;
+    std::cout << "QueueDoubleLine 对象大小: " << sizeof(QueueDoubleLine) << " 字节" << std::endl;
     
     // 清理
     Queue32::destroy(queue32);
     Queue64::destroy(queue64);
     Queue128::destroy(queue128);
     Queue256::destroy(queue256);
+    QueuePow2_64::destroy(queue_pow2_64);
+    QueuePow2_128::destroy(queue_pow2_128);
+    QueueGrouped4::destroy(queue_grouped4);
+    QueuePadded::destroy(queue_padded);
+    QueueOwnerLine::destroy(queue_owner_line);
+    QueueDoubleLine::destroy(queue_double_line);
+    FenceSeparate::destroy(fence_separate);
+    FenceOwnerLine::destroy(fence_owner_line);
+    FenceDoubleLine::destroy(fence_double_line);
     
     return 0;
 }
\ No newline at end of file
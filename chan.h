@@ -7,9 +7,12 @@
 #include <type_traits>
 #include <vector>
 #include <iostream>
+#include "chan_util.h"
+#include "chan_wait.h"
+#include "chan_clock.h"
 
-
-template <typename T>
+// WaitPolicy: 阻塞的push/pop在队列满/空时的等待策略，见chan_wait.h
+template <typename T, typename WaitPolicy = SpinWait>
 class SPSCQueue {
  public:
   explicit SPSCQueue(const int cap) noexcept : cap_(std::max<int>(cap + 1, 4)) {
@@ -17,6 +20,7 @@ class SPSCQueue {
   }
 
   ~SPSCQueue() {
+    flush_tail();
     while (front()) {
       pop();
     }
@@ -37,8 +41,11 @@ class SPSCQueue {
     // head要用来存放内容，那么nextHead需要必须为空
     // 也就是说，必须要head转一圈之后，和tail之间在放满的
     // 情况下也必须空一个空间出来。
-    while (next_head == tail_.load(std::memory_order_acquire)) {
-      // nothing
+    if (next_head == tail_.load(std::memory_order_acquire)) {
+      WaitPolicy waiter;
+      while (next_head == tail_.load(std::memory_order_acquire)) {
+        waiter.wait();
+      }
     }
 
     // 当没有放满的时候
@@ -65,19 +72,242 @@ class SPSCQueue {
     tail_.store(next_tail, std::memory_order_release);
   }
 
+  // 阻塞出队：队列为空时按WaitPolicy等待
+  void pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+  }
+
+  // 延迟释放出队：只推进消费者私有的tail，每release_interval()次、
+  // 或生产者眼中的空位不超过一个间隔时才发布tail_；队列为空时先发布。
+  // 改用其他pop/front接口之前必须调用flush_tail()
+  bool try_pop_deferred(T &out) noexcept {
+    auto const tail = pending_pops_ ? unreleased_tail_ : tail_.load(std::memory_order_relaxed);
+    auto const head = head_.load(std::memory_order_acquire);
+    if (head == tail) {
+      flush_tail();
+      return false;
+    }
+
+    out = std::move(buf_[tail]);
+    buf_[tail].~T();
+    auto next_tail = tail + 1;
+    if (next_tail == cap_) {
+      next_tail = 0;
+    }
+    unreleased_tail_ = next_tail;
+
+    // 以已发布的tail计算生产者能看到的空位
+    int free_slots = tail_.load(std::memory_order_relaxed) - head - 1;
+    if (free_slots < 0) {
+      free_slots += cap_;
+    }
+    if (++pending_pops_ >= release_interval_ ||
+        free_slots <= static_cast<int>(release_interval_)) {
+      flush_tail();
+    }
+    return true;
+  }
+
+  void pop_deferred(T &out) noexcept {
+    if (!try_pop_deferred(out)) {
+      WaitPolicy waiter;
+      while (!try_pop_deferred(out)) {
+        waiter.wait();
+      }
+    }
+  }
+
+  // 立即发布pop_deferred已取出但尚未释放的槽位
+  void flush_tail() noexcept {
+    if (pending_pops_) {
+      pending_pops_ = 0;
+      tail_.store(unreleased_tail_, std::memory_order_release);
+    }
+  }
+
+  void set_release_interval(uint32_t n) noexcept {
+    release_interval_ = n ? n : 1;
+  }
+
+  uint32_t release_interval() const noexcept {
+    return release_interval_;
+  }
+
+  uint32_t pending_pops() const noexcept {
+    return pending_pops_;
+  }
+
+  // 限时入队：队列满时按WaitPolicy等待，超过截止时间仍满则返回false
+  template <typename Clock, typename Duration, typename... Args>
+  bool push_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                  Args &&...args) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto next_head = head + 1;
+    if (next_head == cap_) {
+      next_head = 0;
+    }
+
+    if (next_head == tail_.load(std::memory_order_acquire)) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (next_head == tail_.load(std::memory_order_acquire)) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+
+    new (&buf_[head]) T(std::forward<Args>(args)...);
+    head_.store(next_head, std::memory_order_release);
+    return true;
+  }
+
+  template <typename Rep, typename Period, typename... Args>
+  bool push_for(const std::chrono::duration<Rep, Period> &timeout, Args &&...args) noexcept {
+    return push_until(ChanClock::deadline_after(timeout), std::forward<Args>(args)...);
+  }
+
+  // 限时出队：队列空时按WaitPolicy等待，超过截止时间仍空则返回false
+  template <typename Clock, typename Duration>
+  bool pop_until(T &out, const std::chrono::time_point<Clock, Duration> &deadline) noexcept {
+    T *item = front();
+    if (!item) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+    return true;
+  }
+
+  template <typename Rep, typename Period>
+  bool pop_for(T &out, const std::chrono::duration<Rep, Period> &timeout) noexcept {
+    return pop_until(out, ChanClock::deadline_after(timeout));
+  }
+
+  // 批量入队：最多写入n个元素，返回实际写入的个数
+  // 整批只读取一次tail_(acquire)，只发布一次head_(release)
+  size_t push_n(const T *items, size_t n) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const tail = tail_.load(std::memory_order_acquire);
+    int free_slots = tail - head - 1;
+    if (free_slots < 0) {
+      free_slots += cap_;
+    }
+    n = std::min(n, static_cast<size_t>(free_slots));
+    if (n == 0) {
+      return 0;
+    }
+
+    ChanUtil::copy_into_ring(buf_, cap_, head, items, n);
+    int next_head = head + static_cast<int>(n);
+    if (next_head >= cap_) {
+      next_head -= cap_;
+    }
+    head_.store(next_head, std::memory_order_release);
+    return n;
+  }
+
+  // 批量出队：最多取出max个元素到out，返回实际取出的个数
+  size_t pop_n(T *out, size_t max) noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    auto const head = head_.load(std::memory_order_acquire);
+    int available = head - tail;
+    if (available < 0) {
+      available += cap_;
+    }
+    size_t const n = std::min(max, static_cast<size_t>(available));
+    if (n == 0) {
+      return 0;
+    }
+
+    ChanUtil::move_from_ring(buf_, cap_, tail, out, n);
+    int next_tail = tail + static_cast<int>(n);
+    if (next_tail >= cap_) {
+      next_tail -= cap_;
+    }
+    tail_.store(next_tail, std::memory_order_release);
+    return n;
+  }
+
+  // 零拷贝写入：返回最多n个可写槽位(回绕点处拆成两段)
+  // 调用方用placement new在槽位中构造元素，再调用commit(k)发布前k个
+  ChanUtil::RingSpans<T> reserve(size_t n) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const tail = tail_.load(std::memory_order_acquire);
+    int free_slots = tail - head - 1;
+    if (free_slots < 0) {
+      free_slots += cap_;
+    }
+    n = std::min(n, static_cast<size_t>(free_slots));
+    return ChanUtil::make_spans(buf_, cap_, head, n);
+  }
+
+  // 发布reserve返回的前k个槽位，只做一次release store
+  void commit(size_t k) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    int next_head = head + static_cast<int>(k);
+    if (next_head >= cap_) {
+      next_head -= cap_;
+    }
+    head_.store(next_head, std::memory_order_release);
+  }
+
+  // 零拷贝读取：返回当前所有可读元素(回绕点处拆成两段)，只做一次acquire
+  ChanUtil::RingSpans<T> read_spans() noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    auto const head = head_.load(std::memory_order_acquire);
+    int available = head - tail;
+    if (available < 0) {
+      available += cap_;
+    }
+    return ChanUtil::make_spans(buf_, cap_, tail, static_cast<size_t>(available));
+  }
+
+  // 消费read_spans返回的前k个元素：析构后只做一次release store
+  void release(size_t k) noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    ChanUtil::destroy_in_ring(buf_, cap_, tail, k);
+    int next_tail = tail + static_cast<int>(k);
+    if (next_tail >= cap_) {
+      next_tail -= cap_;
+    }
+    tail_.store(next_tail, std::memory_order_release);
+  }
+
   size_t size() const noexcept {
-    size_t diff = head_.load(std::memory_order_acquire) -
-                  tail_.load(std::memory_order_acquire);
+    // 用有符号数计算差值，否则head回绕到tail之前时diff < 0永远不成立
+    int diff = head_.load(std::memory_order_acquire) -
+               tail_.load(std::memory_order_acquire);
     if (diff < 0) {
       diff += cap_;
     }
-    return diff;
+    return static_cast<size_t>(diff);
   }
 
  private:
   alignas(64) int cap_ = 0;
   alignas(64) std::atomic<int> head_{0};
   alignas(64) std::atomic<int> tail_{0};
+  // pop_deferred的状态，只由消费者访问，与tail_分开避免每次出队都写共享行
+  alignas(64) int unreleased_tail_ = 0;
+  uint32_t pending_pops_ = 0;
+  uint32_t release_interval_ = 1;
   alignas(64) T *buf_ = nullptr;
 };
 
@@ -0,0 +1,353 @@
+#ifndef _PERF_TEST_CHAN_ALLOC_H_
+#define _PERF_TEST_CHAN_ALLOC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#ifdef __linux__
+#include <cstdio>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 对齐的mmap分配器，可选用大页承载队列内存
+//
+// 百万级槽位的环形缓冲区跨越数千个4KB页，遍历一圈会产生大量TLB miss。
+// 用2MB/1GB大页承载后，同样的内存只需要少量TLB项。
+// 显式大页(MAP_HUGETLB)需要系统预留(/proc/sys/vm/nr_hugepages)，
+// 预留不足时依次退化为更小的大页，最后退化为透明大页(madvise(MADV_HUGEPAGE))。
+//
+// NUMA放置直接使用mbind/move_pages/getcpu系统调用，不依赖libnuma；
+// 单节点机器或内核不支持时放置请求静默失效，分配本身不受影响。
+namespace ChanAlloc {
+    enum class PageSize {
+        kSmall,             // 普通4KB页(显式关闭透明大页，作为对照)
+        kTransparentHuge,   // 2MB对齐 + madvise(MADV_HUGEPAGE)，由内核按需合并
+        kHuge2M,            // MAP_HUGETLB 2MB页
+        kHuge1G,            // MAP_HUGETLB 1GB页
+    };
+
+    enum class NumaPlacement {
+        kDefault,           // 不干预，由首次写入的线程决定(first-touch)
+        kProducerNode,      // 环形缓冲区绑定到生产者所在节点
+        kConsumerNode,      // 环形缓冲区绑定到消费者所在节点
+        kInterleave,        // 环形缓冲区在两个节点间按页交错
+    };
+
+    struct Options {
+        PageSize page_size = PageSize::kSmall;
+        NumaPlacement numa = NumaPlacement::kDefault;
+        int producer_node = -1;   // -1表示调用create的线程当前所在的节点
+        int consumer_node = -1;
+        bool prefault = false;    // 创建时写入每一页，首圈push不再触发缺页
+        bool lock_memory = false; // mlock锁定，避免被换出(受RLIMIT_MEMLOCK限制)
+    };
+
+    // 一次分配的记录，释放时按它选择munmap或operator delete
+    struct Allocation {
+        void* base = nullptr;
+        size_t length = 0;
+        size_t alignment = 0;
+        PageSize page_size = PageSize::kSmall;   // 实际使用的页面类型(可能已退化)
+        bool mapped = false;                     // false表示退化为operator new
+        bool numa_bound = false;                 // NUMA放置是否生效
+        bool prefaulted = false;                 // 是否已预先触发所有页的缺页
+        bool locked = false;                     // mlock是否成功
+    };
+
+    static inline const char* page_size_name(PageSize page_size) noexcept {
+        switch (page_size) {
+            case PageSize::kSmall: return "4KB";
+            case PageSize::kTransparentHuge: return "THP";
+            case PageSize::kHuge2M: return "2MB";
+            case PageSize::kHuge1G: return "1GB";
+        }
+        return "?";
+    }
+
+    static constexpr size_t kSmallPage = size_t(4) << 10;
+    static constexpr size_t kHugePage2M = size_t(2) << 20;
+    static constexpr size_t kHugePage1G = size_t(1) << 30;
+
+    static inline size_t round_up(size_t bytes, size_t unit) noexcept {
+        return (bytes + unit - 1) / unit * unit;
+    }
+
+    static inline const char* numa_placement_name(NumaPlacement placement) noexcept {
+        switch (placement) {
+            case NumaPlacement::kDefault: return "first-touch";
+            case NumaPlacement::kProducerNode: return "producer";
+            case NumaPlacement::kConsumerNode: return "consumer";
+            case NumaPlacement::kInterleave: return "interleave";
+        }
+        return "?";
+    }
+
+#ifdef __linux__
+    static constexpr int kMaxNodes = 1024;
+    static constexpr int kMpolBind = 2;          // MPOL_BIND
+    static constexpr int kMpolInterleave = 3;    // MPOL_INTERLEAVE
+    static constexpr unsigned kMpolMfMove = 2;   // MPOL_MF_MOVE: 已分配的页也迁移过去
+
+    // 系统中在线的最大节点号 + 1，读取失败时按单节点处理
+    static inline int numa_node_count() noexcept {
+        static const int count = []() {
+            FILE* file = fopen("/sys/devices/system/node/online", "r");
+            if (!file) {
+                return 1;
+            }
+            // 格式如"0"或"0-3"或"0,2-3"，取出现的最大节点号
+            int max_node = 0, value = 0;
+            bool in_number = false;
+            for (int c = fgetc(file); c != EOF; c = fgetc(file)) {
+                if (c >= '0' && c <= '9') {
+                    value = value * 10 + (c - '0');
+                    in_number = true;
+                } else if (in_number) {
+                    max_node = value > max_node ? value : max_node;
+                    value = 0;
+                    in_number = false;
+                }
+            }
+            if (in_number && value > max_node) {
+                max_node = value;
+            }
+            fclose(file);
+            return max_node + 1;
+        }();
+        return count;
+    }
+
+    // 调用线程当前所在的节点
+    static inline int current_node() noexcept {
+        unsigned cpu = 0, node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+            return 0;
+        }
+        return static_cast<int>(node);
+    }
+
+    // 查询addr所在页当前位于哪个节点(move_pages的查询模式)，页尚未分配或失败时返回-1
+    static inline int node_of(const void* addr) noexcept {
+        void* page = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(addr) & ~(kSmallPage - 1));
+        int status = -1;
+        if (syscall(SYS_move_pages, 0, 1UL, &page, nullptr, &status, 0) != 0) {
+            return -1;
+        }
+        return status;
+    }
+
+    // 对[begin, end)覆盖的整页设置内存策略；nodes中的节点号小于0的忽略
+    static inline bool bind_pages(const void* begin, const void* end, int mode,
+                                  const int* nodes, int node_count) noexcept {
+        unsigned long mask[kMaxNodes / (8 * sizeof(unsigned long))] = {};
+        bool any = false;
+        for (int i = 0; i < node_count; ++i) {
+            if (nodes[i] >= 0 && nodes[i] < kMaxNodes) {
+                mask[nodes[i] / (8 * sizeof(unsigned long))] |= 1UL << (nodes[i] % (8 * sizeof(unsigned long)));
+                any = true;
+            }
+        }
+        uintptr_t const first = reinterpret_cast<uintptr_t>(begin) & ~(kSmallPage - 1);
+        uintptr_t const last = round_up(reinterpret_cast<uintptr_t>(end), kSmallPage);
+        if (!any || last <= first) {
+            return false;
+        }
+        // maxnode按内核的习惯多传1
+        return syscall(SYS_mbind, first, last - first, mode, mask,
+                       static_cast<unsigned long>(kMaxNodes) + 1, kMpolMfMove) == 0;
+    }
+
+    // 把一侧独占的索引缓存行所在的页绑定到该侧节点：
+    // 只处理与对端索引区域[other_begin, other_end)不共享的页，共享的页保持缓冲区的策略
+    static inline bool bind_owned_pages(const void* begin, const void* end,
+                                        const void* other_begin, const void* other_end,
+                                        int node) noexcept {
+        uintptr_t first = reinterpret_cast<uintptr_t>(begin) & ~(kSmallPage - 1);
+        uintptr_t last = round_up(reinterpret_cast<uintptr_t>(end), kSmallPage);
+        uintptr_t const other_first = reinterpret_cast<uintptr_t>(other_begin) & ~(kSmallPage - 1);
+        uintptr_t const other_last = round_up(reinterpret_cast<uintptr_t>(other_end), kSmallPage);
+        if (first < other_last && first >= other_first) {
+            first = other_last;
+        }
+        if (last > other_first && last <= other_last) {
+            last = other_first;
+        }
+        if (last <= first) {
+            return false;
+        }
+        return bind_pages(reinterpret_cast<const void*>(first), reinterpret_cast<const void*>(last),
+                          kMpolBind, &node, 1);
+    }
+
+    // 把options中的-1节点解析为当前线程所在节点
+    static inline void resolve_nodes(Options& options) noexcept {
+        if (options.producer_node < 0) {
+            options.producer_node = current_node();
+        }
+        if (options.consumer_node < 0) {
+            options.consumer_node = current_node();
+        }
+    }
+
+    // 按options.numa为整块内存设置策略，必须在首次写入之前调用
+    static inline bool place_buffer(void* memory, size_t length, const Options& options) noexcept {
+        if (options.numa == NumaPlacement::kDefault || numa_node_count() < 2) {
+            return false;
+        }
+        const char* end = static_cast<const char*>(memory) + length;
+        switch (options.numa) {
+            case NumaPlacement::kProducerNode:
+                return bind_pages(memory, end, kMpolBind, &options.producer_node, 1);
+            case NumaPlacement::kConsumerNode:
+                return bind_pages(memory, end, kMpolBind, &options.consumer_node, 1);
+            case NumaPlacement::kInterleave: {
+                int nodes[2] = {options.producer_node, options.consumer_node};
+                return bind_pages(memory, end, kMpolInterleave, nodes, 2);
+            }
+            case NumaPlacement::kDefault:
+                break;
+        }
+        return false;
+    }
+#endif
+
+#ifdef __linux__
+    // MAP_HUGETLB映射，返回的地址天然按大页对齐
+    static inline void* map_hugetlb(size_t bytes, size_t page, int size_flag, Allocation& out) noexcept {
+        size_t const length = round_up(bytes, page);
+        void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | size_flag, -1, 0);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        out.base = memory;
+        out.length = length;
+        return memory;
+    }
+
+    // 多映射alignment字节再裁掉首尾，得到按alignment对齐的普通匿名映射
+    static inline void* map_aligned(size_t bytes, size_t alignment, Allocation& out) noexcept {
+        size_t const length = round_up(bytes, kSmallPage);
+        size_t const padded = length + alignment;
+        void* memory = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            return nullptr;
+        }
+        uintptr_t const start = reinterpret_cast<uintptr_t>(memory);
+        uintptr_t const aligned = round_up(start, alignment);
+        if (aligned > start) {
+            munmap(memory, aligned - start);
+        }
+        size_t const tail = start + padded - (aligned + length);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        out.base = reinterpret_cast<void*>(aligned);
+        out.length = length;
+        return out.base;
+    }
+#endif
+
+    // 按页面类型映射内存，失败返回nullptr
+    static inline void* allocate_pages(size_t bytes, size_t alignment, const Options& options,
+                                       Allocation& out) noexcept {
+        out = Allocation{};
+        out.alignment = alignment;
+#ifdef __linux__
+        out.mapped = true;
+        void* memory = nullptr;
+        switch (options.page_size) {
+            case PageSize::kHuge1G:
+#ifdef MAP_HUGE_1GB
+                if ((memory = map_hugetlb(bytes, kHugePage1G, MAP_HUGE_1GB, out))) {
+                    out.page_size = PageSize::kHuge1G;
+                    return memory;
+                }
+#endif
+                // fallthrough
+            case PageSize::kHuge2M:
+#ifdef MAP_HUGE_2MB
+                if ((memory = map_hugetlb(bytes, kHugePage2M, MAP_HUGE_2MB, out))) {
+#else
+                if ((memory = map_hugetlb(bytes, kHugePage2M, 0, out))) {
+#endif
+                    out.page_size = PageSize::kHuge2M;
+                    return memory;
+                }
+                // fallthrough
+            case PageSize::kTransparentHuge:
+                if ((memory = map_aligned(bytes, alignment > kHugePage2M ? alignment : kHugePage2M, out))) {
+                    madvise(memory, out.length, MADV_HUGEPAGE);
+                    out.page_size = PageSize::kTransparentHuge;
+                    return memory;
+                }
+                return nullptr;
+            case PageSize::kSmall:
+                if ((memory = map_aligned(bytes, alignment > kSmallPage ? alignment : kSmallPage, out))) {
+                    // 系统把透明大页设为always时也保持4KB页，便于对照
+                    madvise(memory, out.length, MADV_NOHUGEPAGE);
+                    out.page_size = PageSize::kSmall;
+                    return memory;
+                }
+                return nullptr;
+        }
+        return nullptr;
+#else
+        (void)options;
+        out.base = operator new(bytes, std::align_val_t(alignment), std::nothrow);
+        out.length = bytes;
+        return out.base;
+#endif
+    }
+
+    // 逐页写入一个字节，让内核在创建时就分配好物理页并建立页表项。
+    // 新映射的内存全为0，写0不改变内容；NUMA策略已在此之前设置，页会落在目标节点上
+    static inline void prefault_pages(void* memory, size_t length) noexcept {
+        volatile char* bytes = static_cast<volatile char*>(memory);
+        for (size_t offset = 0; offset < length; offset += kSmallPage) {
+            bytes[offset] = bytes[offset];
+        }
+    }
+
+    // 分配至少bytes字节、按alignment对齐的内存，并在首次写入前按options.numa放置，
+    // 再按options预先缺页、锁定内存，失败返回nullptr
+    static inline void* allocate(size_t bytes, size_t alignment, const Options& options,
+                                 Allocation& out) noexcept {
+        void* memory = allocate_pages(bytes, alignment, options, out);
+        if (!memory) {
+            return nullptr;
+        }
+#ifdef __linux__
+        if (out.mapped) {
+            out.numa_bound = place_buffer(memory, out.length, options);
+        }
+        if (options.lock_memory) {
+            // mlock本身也会让所有页常驻
+            out.locked = mlock(memory, out.length) == 0;
+        }
+#endif
+        if (options.prefault) {
+            prefault_pages(memory, out.length);
+            out.prefaulted = true;
+        }
+        return memory;
+    }
+
+    static inline void release(const Allocation& allocation) noexcept {
+        if (!allocation.base) {
+            return;
+        }
+#ifdef __linux__
+        if (allocation.mapped) {
+            munmap(allocation.base, allocation.length);
+            return;
+        }
+#endif
+        operator delete(allocation.base, std::align_val_t(allocation.alignment));
+    }
+}
+
+#endif  // _PERF_TEST_CHAN_ALLOC_H_
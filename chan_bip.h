@@ -0,0 +1,170 @@
+#ifndef _PERF_TEST_CHAN_BIP_H_
+#define _PERF_TEST_CHAN_BIP_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include "chan_util.h"
+
+// 变长记录的SPSC字节环(bip-buffer风格)
+//
+// 每条记录 = 8字节头(负载长度) + 负载，按8字节对齐连续存放。
+// 记录从不跨越回绕点：尾部剩余空间放不下时，生产者写一个填充头占满尾部，
+// 记录从缓冲区开头开始，消费者读到填充头直接跳到开头。
+// head_/tail_是单调递增的64位字节偏移，Capacity必须是2的幂。
+//
+// 生产者: auto* p = ring->reserve(n); 在p上写入最多n字节; ring->commit(used);
+// 消费者: auto rec = ring->peek(); 处理rec.data/rec.size; ring->release();
+template <size_t Capacity, uint32_t kCacheLineSize = 64>
+class SPSCByteRing {
+  static_assert(Capacity >= 64 && (Capacity & (Capacity - 1)) == 0,
+                "SPSCByteRing requires a power-of-two capacity of at least 64 bytes");
+
+ public:
+  static SPSCByteRing* create() noexcept {
+    void* raw_memory = operator new(sizeof(SPSCByteRing), std::align_val_t(kCacheLineSize),
+                                    std::nothrow);
+    if (!raw_memory) {
+      return nullptr;
+    }
+    return new(raw_memory) SPSCByteRing();
+  }
+
+  static void destroy(SPSCByteRing* ring) noexcept {
+    if (ring) {
+      ring->~SPSCByteRing();
+      operator delete(ring, std::align_val_t(kCacheLineSize));
+    }
+  }
+
+  // 单条记录负载的最大长度：保证在任意位置都能等到足够的连续空间
+  static constexpr size_t max_record_size() noexcept {
+    return Capacity / 2 - kHeaderSize;
+  }
+
+  // 预留一段bytes字节的连续可写空间，空间不足时返回nullptr
+  uint8_t* reserve(size_t bytes) noexcept {
+    if (bytes > max_record_size()) {
+      return nullptr;
+    }
+    uint64_t const head = head_.load(std::memory_order_relaxed);
+    size_t const offset = head & kMask;
+    size_t const record = record_size(bytes);
+    // 尾部放不下就整体填充到缓冲区末尾，记录从开头开始
+    size_t const pad = (Capacity - offset < record) ? Capacity - offset : 0;
+
+    if (Capacity - (head - cached_tail_) < pad + record) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (Capacity - (head - cached_tail_) < pad + record) {
+        return nullptr;
+      }
+    }
+
+    pending_pad_ = pad;
+    return buf_ + ((head + pad) & kMask) + kHeaderSize;
+  }
+
+  // 发布最近一次reserve的记录，bytes为实际写入的字节数(不超过预留大小)
+  void commit(size_t bytes) noexcept {
+    uint64_t const head = head_.load(std::memory_order_relaxed);
+    if (pending_pad_) {
+      write_header(head & kMask, kPaddingMarker);
+    }
+    uint64_t const start = head + pending_pad_;
+    write_header(start & kMask, static_cast<uint32_t>(bytes));
+    head_.store(start + record_size(bytes), std::memory_order_release);
+  }
+
+  // 拷贝一条记录进环，空间不足时返回false
+  bool push(const void* data, size_t bytes) noexcept {
+    uint8_t* dst = reserve(bytes);
+    if (!dst) {
+      return false;
+    }
+    std::memcpy(dst, data, bytes);
+    commit(bytes);
+    return true;
+  }
+
+  // 返回下一条记录的负载(只读、连续)，没有记录时返回size为0、data为nullptr
+  ChanUtil::RingSpan<const uint8_t> peek() noexcept {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) {
+        return {};
+      }
+    }
+
+    uint32_t length = read_header(tail & kMask);
+    if (length == kPaddingMarker) {
+      // 跳过尾部填充，填充之后一定紧跟一条记录
+      tail += Capacity - (tail & kMask);
+      length = read_header(tail & kMask);
+    }
+    peek_tail_ = tail;
+    return {buf_ + (tail & kMask) + kHeaderSize, length};
+  }
+
+  // 消费peek返回的记录(连同之前跳过的填充)，只做一次release store
+  void release() noexcept {
+    uint32_t const length = read_header(peek_tail_ & kMask);
+    tail_.store(peek_tail_ + record_size(length), std::memory_order_release);
+  }
+
+  // 已占用的字节数(包括记录头和填充)
+  size_t bytes_used() const noexcept {
+    uint64_t const tail = tail_.load(std::memory_order_acquire);
+    uint64_t const head = head_.load(std::memory_order_acquire);
+    return static_cast<size_t>(head - tail);
+  }
+
+  size_t capacity() const noexcept {
+    return Capacity;
+  }
+
+ private:
+  static constexpr uint64_t kMask = Capacity - 1;
+  static constexpr size_t kHeaderSize = 8;
+  static constexpr uint32_t kPaddingMarker = 0xFFFFFFFFu;
+
+  SPSCByteRing() noexcept = default;
+  ~SPSCByteRing() = default;
+
+  // 禁止拷贝和移动
+  SPSCByteRing(const SPSCByteRing&) = delete;
+  SPSCByteRing& operator=(const SPSCByteRing&) = delete;
+  SPSCByteRing(SPSCByteRing&&) = delete;
+  SPSCByteRing& operator=(SPSCByteRing&&) = delete;
+
+  // 记录头 + 负载，向上对齐到8字节
+  static constexpr size_t record_size(size_t bytes) noexcept {
+    return (kHeaderSize + bytes + 7) & ~static_cast<size_t>(7);
+  }
+
+  void write_header(size_t offset, uint32_t length) noexcept {
+    std::memcpy(buf_ + offset, &length, sizeof(length));
+  }
+
+  uint32_t read_header(size_t offset) const noexcept {
+    uint32_t length;
+    std::memcpy(&length, buf_ + offset, sizeof(length));
+    return length;
+  }
+
+  // 生产者写head_，并在独立的缓存行上保存tail_的本地副本和预留状态
+  alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+  alignas(kCacheLineSize) uint64_t cached_tail_ = 0;
+  size_t pending_pad_ = 0;
+
+  // 消费者写tail_，并在独立的缓存行上保存head_的本地副本和peek状态
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail_{0};
+  alignas(kCacheLineSize) uint64_t cached_head_ = 0;
+  uint64_t peek_tail_ = 0;
+
+  alignas(kCacheLineSize) uint8_t buf_[Capacity];
+};
+
+#endif  // _PERF_TEST_CHAN_BIP_H_
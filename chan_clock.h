@@ -0,0 +1,124 @@
+#ifndef _PERF_TEST_CHAN_CLOCK_H_
+#define _PERF_TEST_CHAN_CLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 低开销时间源：x86上用TSC，AArch64上用通用定时器，其他平台退化为steady_clock
+//
+// 用于等待循环中的超时检查和基准测试中的时间戳，假设TSC是恒定频率的
+// (invariant TSC，近十年的x86服务器CPU都满足)。
+// 函数为inline(外部链接)，所有编译单元共用同一次校准
+namespace ChanClock {
+    inline uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // 测量每纳秒的tick数：x86上要忙等约2毫秒，不要直接调用，用ticks_per_ns()
+    inline double calibrate() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        // 在约2毫秒的窗口内同时读取steady_clock和TSC来换算频率
+        auto start_time = std::chrono::steady_clock::now();
+        uint64_t start_ticks = __rdtsc();
+        while (std::chrono::steady_clock::now() - start_time < std::chrono::milliseconds(2)) {
+        }
+        uint64_t end_ticks = __rdtsc();
+        auto end_time = std::chrono::steady_clock::now();
+        double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            end_time - start_time).count());
+        return static_cast<double>(end_ticks - start_ticks) / ns;
+#elif defined(__aarch64__)
+        uint64_t frequency;
+        __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return static_cast<double>(frequency) / 1e9;
+#else
+        return 1.0;
+#endif
+    }
+
+    // 每纳秒的tick数，整个进程只校准一次
+    inline double ticks_per_ns() noexcept {
+        static const double value = calibrate();
+        return value;
+    }
+
+    // 程序启动时(静态初始化阶段)就完成校准，第一次限时push/pop不会在等待中途多花2毫秒
+    inline const double kStartupTicksPerNs = ticks_per_ns();
+
+    // 超出uint64_t范围时饱和到UINT64_MAX(double转整数越界是未定义行为)
+    inline uint64_t ns_to_ticks(int64_t ns) noexcept {
+        if (ns <= 0) {
+            return 0;
+        }
+        double const value = ns * ticks_per_ns();
+        return value >= 18446744073709551616.0 ? UINT64_MAX : static_cast<uint64_t>(value);
+    }
+
+    inline double ticks_to_ns(uint64_t ticks) noexcept {
+        return static_cast<double>(ticks) / ticks_per_ns();
+    }
+
+    // 相对超时换算成steady_clock的截止时间；now + timeout会溢出时(如nanoseconds::max())
+    // 饱和到time_point::max()，即永不超时。供各实现的*_for()使用
+    template <typename Rep, typename Period>
+    inline std::chrono::steady_clock::time_point deadline_after(
+            const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        using Clock = std::chrono::steady_clock;
+        using Timeout = std::chrono::duration<Rep, Period>;
+        auto const now = Clock::now();
+        if (timeout <= Timeout::zero()) {
+            return now;
+        }
+        // 在调用方的单位上比较，避免hours::max()之类换算成纳秒时先溢出
+        if (timeout >= std::chrono::duration_cast<Timeout>(Clock::time_point::max() - now)) {
+            return Clock::time_point::max();
+        }
+        return now + std::chrono::ceil<Clock::duration>(timeout);
+    }
+
+    // 截止时间：构造时读取一次调用方的时钟并换算成tick，
+    // 之后expired()只读取TSC，不会让时间检查拖慢自旋循环。
+    // 超出tick计数范围的截止时间(如time_point::max())饱和为永不到期
+    class Deadline {
+     public:
+        template <typename Clock, typename Duration>
+        explicit Deadline(const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+            // 先取得校准结果再读取now，即使校准还没做过，花掉的时间也不会算进等待时长；
+            // 在Duration的精度上相减，deadline很远时也不会溢出
+            double const per_ns = ticks_per_ns();
+            auto const now = std::chrono::time_point_cast<Duration>(Clock::now());
+            if (deadline <= now) {
+                deadline_ticks_ = 0;
+                return;
+            }
+            double const remaining = std::chrono::duration<double, std::nano>(deadline - now).count() * per_ns;
+            uint64_t const start = ticks();
+            deadline_ticks_ = remaining >= static_cast<double>(kNever - start)
+                                  ? kNever
+                                  : start + static_cast<uint64_t>(remaining);
+        }
+
+        bool expired() const noexcept {
+            return deadline_ticks_ != kNever && ticks() >= deadline_ticks_;
+        }
+
+     private:
+        static constexpr uint64_t kNever = UINT64_MAX;
+
+        uint64_t deadline_ticks_;
+    };
+}
+
+#endif  // _PERF_TEST_CHAN_CLOCK_H_
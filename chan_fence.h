@@ -6,6 +6,10 @@
 #include <iostream>
 #include <new>
 #include <cstdint>
+#include "chan_util.h"
+#include "chan_wait.h"
+#include "chan_clock.h"
+#include "chan_layout.h"
 
 // 跨平台内存屏障实现
 namespace Fence {
@@ -66,7 +70,10 @@ namespace Fence {
     }
 }
 
-template <typename T, uint32_t Capacity, uint32_t kCacheLineSize = 64>
+// WaitPolicy: 阻塞的push/pop在队列满/空时的等待策略，见chan_wait.h
+// IndexLayout: head_/tail_及消费者私有状态的布局，见chan_layout.h
+template <typename T, uint32_t Capacity, uint32_t kCacheLineSize = 64,
+          typename WaitPolicy = SpinWait, typename IndexLayout = ChanLayout::IndexSeparate>
 class SPSCQueueFence {
 public:
     // 使用placement new创建SPSC队列
@@ -74,8 +81,9 @@ public:
         // 计算需要的总内存大小
         size_t total_size = sizeof(SPSCQueueFence);
         
-        // 分配内存，确保对齐
-        void* raw_memory = operator new(total_size, std::align_val_t(kCacheLineSize));
+        // 按对象自身的对齐分配(IndexDoubleLine时为两个缓存行，大于kCacheLineSize)
+        void* raw_memory = operator new(total_size, std::align_val_t(alignof(SPSCQueueFence)),
+                                        std::nothrow);
         if (!raw_memory) {
             return nullptr;
         }
@@ -88,7 +96,8 @@ public:
     // 自定义删除函数
     static void destroy(SPSCQueueFence* queue) noexcept {
         if (queue) {
-            // 清空所有元素
+            // 先发布延迟的tail_，再清空所有元素
+            queue->flush_tail();
             while (queue->front()) {
                 queue->pop();
             }
@@ -97,7 +106,7 @@ public:
             queue->~SPSCQueueFence();
             
             // 释放内存
-            operator delete(queue, std::align_val_t(kCacheLineSize));
+            operator delete(queue, std::align_val_t(alignof(SPSCQueueFence)));
         }
     }
 
@@ -113,13 +122,15 @@ public:
         // 检查队列是否满了
         // 需要读取consumer更新的tail值，使用lfence确保读取最新值
         int current_tail;
+        WaitPolicy waiter;
         do {
             Fence::lfence();  // 确保读取到最新的tail值
             current_tail = tail_;
             if (next_head != current_tail) {
                 break;  // 队列未满，可以继续
             }
-            // 队列满了，继续等待
+            // 队列满了，按WaitPolicy等待
+            waiter.wait();
             Fence::compiler_fence();  // 防止编译器优化掉循环
         } while (true);
 
@@ -164,6 +175,201 @@ public:
         tail_ = next_tail;
     }
 
+    // 阻塞出队：队列为空时按WaitPolicy等待
+    void pop(T& out) noexcept {
+        T* item = front();
+        if (!item) {
+            WaitPolicy waiter;
+            while (!(item = front())) {
+                waiter.wait();
+                Fence::compiler_fence();
+            }
+        }
+        out = std::move(*item);
+        pop();
+    }
+
+    // 延迟释放出队：只推进消费者私有的tail，每release_interval()次、
+    // 或生产者眼中的空位不超过一个间隔时才用sfence + store发布tail_；队列为空时先发布。
+    // 改用其他pop/front接口之前必须调用flush_tail()
+    bool try_pop_deferred(T& out) noexcept {
+        const int tail = pending_pops_ ? unreleased_tail_ : tail_;
+        Fence::lfence();  // 确保读取到最新的head值
+        const int head = head_;
+        if (head == tail) {
+            flush_tail();
+            return false;
+        }
+
+        // 读取head之后再读数据，防止数据读取被提前
+        Fence::lfence();
+        out = std::move(buf_[tail]);
+        buf_[tail].~T();
+        int next_tail = tail + 1;
+        if (next_tail == static_cast<int>(Capacity)) {
+            next_tail = 0;
+        }
+        unreleased_tail_ = next_tail;
+
+        // 以已发布的tail计算生产者能看到的空位
+        int free_slots = tail_ - head - 1;
+        if (free_slots < 0) {
+            free_slots += static_cast<int>(Capacity);
+        }
+        if (++pending_pops_ >= release_interval_ ||
+            free_slots <= static_cast<int>(release_interval_)) {
+            flush_tail();
+        }
+        return true;
+    }
+
+    void pop_deferred(T& out) noexcept {
+        if (!try_pop_deferred(out)) {
+            WaitPolicy waiter;
+            while (!try_pop_deferred(out)) {
+                waiter.wait();
+                Fence::compiler_fence();
+            }
+        }
+    }
+
+    // 立即发布pop_deferred已取出但尚未释放的槽位
+    void flush_tail() noexcept {
+        if (pending_pops_) {
+            pending_pops_ = 0;
+            // 确保析构完成后再更新tail指针
+            Fence::sfence();
+            tail_ = unreleased_tail_;
+        }
+    }
+
+    void set_release_interval(uint32_t n) noexcept {
+        release_interval_ = n ? n : 1;
+    }
+
+    uint32_t release_interval() const noexcept {
+        return release_interval_;
+    }
+
+    uint32_t pending_pops() const noexcept {
+        return pending_pops_;
+    }
+
+    // 限时入队：队列满时按WaitPolicy等待，超过截止时间仍满则返回false
+    template <typename Clock, typename Duration, typename... Args>
+    bool push_until(const std::chrono::time_point<Clock, Duration>& deadline,
+                    Args&&... args) noexcept {
+        const int head = head_;
+        int next_head = head + 1;
+        if (next_head == static_cast<int>(Capacity)) {
+            next_head = 0;
+        }
+
+        Fence::lfence();
+        if (next_head == tail_) {
+            ChanClock::Deadline timer(deadline);
+            WaitPolicy waiter;
+            do {
+                if (timer.expired()) {
+                    return false;
+                }
+                waiter.wait();
+                Fence::lfence();
+            } while (next_head == tail_);
+        }
+
+        new (&buf_[head]) T(std::forward<Args>(args)...);
+        Fence::sfence();
+        head_ = next_head;
+        return true;
+    }
+
+    template <typename Rep, typename Period, typename... Args>
+    bool push_for(const std::chrono::duration<Rep, Period>& timeout, Args&&... args) noexcept {
+        return push_until(ChanClock::deadline_after(timeout), std::forward<Args>(args)...);
+    }
+
+    // 限时出队：队列空时按WaitPolicy等待，超过截止时间仍空则返回false
+    template <typename Clock, typename Duration>
+    bool pop_until(T& out, const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+        T* item = front();
+        if (!item) {
+            ChanClock::Deadline timer(deadline);
+            WaitPolicy waiter;
+            while (!(item = front())) {
+                if (timer.expired()) {
+                    return false;
+                }
+                waiter.wait();
+            }
+        }
+        out = std::move(*item);
+        pop();
+        return true;
+    }
+
+    template <typename Rep, typename Period>
+    bool pop_for(T& out, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        return pop_until(out, ChanClock::deadline_after(timeout));
+    }
+
+    // 批量入队：最多写入n个元素，返回实际写入的个数
+    // 整批只做一次lfence读取tail，一次sfence发布head
+    size_t push_n(const T* items, size_t n) noexcept {
+        const int head = head_;
+        Fence::lfence();  // 确保读取到最新的tail值
+        const int tail = tail_;
+
+        int free_slots = tail - head - 1;
+        if (free_slots < 0) {
+            free_slots += static_cast<int>(Capacity);
+        }
+        n = std::min(n, static_cast<size_t>(free_slots));
+        if (n == 0) {
+            return 0;
+        }
+
+        ChanUtil::copy_into_ring(buf_, Capacity, head, items, n);
+
+        int next_head = head + static_cast<int>(n);
+        if (next_head >= static_cast<int>(Capacity)) {
+            next_head -= static_cast<int>(Capacity);
+        }
+        // 确保整批数据写入在head更新之前完成
+        Fence::sfence();
+        head_ = next_head;
+        return n;
+    }
+
+    // 批量出队：最多取出max个元素到out，返回实际取出的个数
+    size_t pop_n(T* out, size_t max) noexcept {
+        const int tail = tail_;
+        Fence::lfence();  // 确保读取到最新的head值
+        const int head = head_;
+
+        int available = head - tail;
+        if (available < 0) {
+            available += static_cast<int>(Capacity);
+        }
+        const size_t n = std::min(max, static_cast<size_t>(available));
+        if (n == 0) {
+            return 0;
+        }
+
+        // 读取head之后再读数据，防止数据读取被提前
+        Fence::lfence();
+        ChanUtil::move_from_ring(buf_, Capacity, tail, out, n);
+
+        int next_tail = tail + static_cast<int>(n);
+        if (next_tail >= static_cast<int>(Capacity)) {
+            next_tail -= static_cast<int>(Capacity);
+        }
+        // 确保数据读取完成后再更新tail指针
+        Fence::sfence();
+        tail_ = next_tail;
+        return n;
+    }
+
     size_t size() const noexcept {
         // 需要获取一致的快照，但对于SPSC来说可以简化
         Fence::lfence();  // 确保读取到最新值
@@ -181,6 +387,21 @@ public:
         return static_cast<int>(Capacity);
     }
 
+    // head_、tail_和第一个槽位相对队列起始地址的偏移，用于检查IndexLayout的实际效果
+    struct IndexOffsets {
+        size_t head;
+        size_t tail;
+        size_t first_slot;
+    };
+
+    IndexOffsets index_offsets() noexcept {
+        auto const offset = [this](const volatile void* field) {
+            return static_cast<size_t>(reinterpret_cast<const volatile char*>(field) -
+                                       reinterpret_cast<const volatile char*>(this));
+        };
+        return {offset(&head_), offset(&tail_), offset(&buf_[0])};
+    }
+
     // 获取队列类型名称，用于测试识别
     static const char* queue_type() {
         return "SPSCQueueFence";
@@ -194,7 +415,8 @@ private:
     }
     
     // 私有析构函数，只能通过destroy方法销毁
-    ~SPSCQueueFence() = default;
+    // 剩余元素已在destroy中pop析构，这里不能再次析构buf_
+    ~SPSCQueueFence() {}
 
     // 禁止拷贝和移动
     SPSCQueueFence(const SPSCQueueFence&) = delete;
@@ -202,19 +424,30 @@ private:
     SPSCQueueFence(SPSCQueueFence&&) = delete;
     SPSCQueueFence& operator=(SPSCQueueFence&&) = delete;
 
+    // 索引块的对齐；kCached为0时私有状态按自然对齐紧跟在tail_之后
+    using IndexAlign = typename IndexLayout::template Align<kCacheLineSize>;
+    static constexpr size_t kIndexAlign = IndexAlign::kIndex;
+    static constexpr size_t kCachedAlign = IndexAlign::kCached ? IndexAlign::kCached : alignof(int);
+
     // Producer端变量 (主要由producer线程访问)
     // 使用volatile确保每次都从内存读取，配合fence使用
-    alignas(kCacheLineSize) volatile int head_;
-
-    // Cache line分隔符，避免false sharing
-    // 确保head_和tail_在不同的缓存行中
-    char cache_line_spacer_[kCacheLineSize - sizeof(volatile int)];
+    // head_和tail_按IndexLayout对齐到不同的缓存行(或双行)，避免false sharing
+    alignas(kIndexAlign) volatile int head_;
 
     // Consumer端变量 (主要由consumer线程访问)
-    alignas(kCacheLineSize) volatile int tail_;
+    alignas(kIndexAlign) volatile int tail_;
+
+    // pop_deferred的状态，只由consumer访问；分离布局下放在独立的缓存行，
+    // 避免每次出队都写生产者要读的tail_所在行，按所有者分行时与tail_同行
+    alignas(kCachedAlign) int unreleased_tail_ = 0;
+    uint32_t pending_pops_ = 0;
+    uint32_t release_interval_ = 1;
     
-    // 数据缓冲区，独立的缓存行
-    alignas(kCacheLineSize) T buf_[Capacity];
+    // 数据缓冲区，独立的缓存行(双行填充时与索引块之间隔开两行)
+    // 放在匿名union中，元素的生命周期完全由push/pop管理
+    union {
+        alignas(kIndexAlign) T buf_[Capacity];
+    };
 };
 
 #endif  // _PERF_TEST_CHAN_FENCE_H_
\ No newline at end of file
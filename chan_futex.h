@@ -0,0 +1,139 @@
+#ifndef _PERF_TEST_CHAN_FUTEX_H_
+#define _PERF_TEST_CHAN_FUTEX_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <thread>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "chan_wait.h"
+
+// 基于futex的eventcount和自适应自旋，用于空闲时休眠、有数据时快速唤醒
+//
+// 等待方协议:
+//   key = ec.prepare_wait();      // 宣布自己准备休眠
+//   if (条件已满足) ec.cancel_wait();
+//   else ec.wait(key);            // 在futex上休眠，直到notify
+// 通知方协议:
+//   发布数据(release store);
+//   std::atomic_thread_fence(std::memory_order_seq_cst);
+//   ec.notify();                  // 只有存在等待者时才发起futex wake系统调用
+namespace ChanFutex {
+#ifdef __linux__
+    static inline void futex_wait(std::atomic<uint32_t>* addr, uint32_t expected) noexcept {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT_PRIVATE,
+                expected, nullptr, nullptr, 0);
+    }
+
+    static inline void futex_wake_all(std::atomic<uint32_t>* addr) noexcept {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE_PRIVATE,
+                INT_MAX, nullptr, nullptr, 0);
+    }
+#else
+    // 非Linux平台没有futex，退化为短睡眠轮询
+    static inline void futex_wait(std::atomic<uint32_t>* addr, uint32_t expected) noexcept {
+        if (addr->load(std::memory_order_acquire) == expected) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    static inline void futex_wake_all(std::atomic<uint32_t>*) noexcept {}
+#endif
+}
+
+class EventCount {
+ public:
+    // 宣布准备等待，返回当前纪元作为wait的key
+    uint32_t prepare_wait() noexcept {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        // 与通知方的seq_cst fence配对：之后对条件的检查一定能看到
+        // 通知方在fence之前发布的数据，或者通知方能看到这里的waiters_
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    // 条件在prepare_wait之后已经满足，不再休眠
+    void cancel_wait() noexcept {
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // 休眠直到纪元变化(被notify)
+    void wait(uint32_t key) noexcept {
+        while (epoch_.load(std::memory_order_acquire) == key) {
+            ChanFutex::futex_wait(&epoch_, key);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // 调用前需要先有一次seq_cst fence；没有等待者时只是一次普通load
+    void notify() noexcept {
+        if (waiters_.load(std::memory_order_relaxed) != 0) {
+            epoch_.fetch_add(1, std::memory_order_release);
+            ChanFutex::futex_wake_all(&epoch_);
+        }
+    }
+
+ private:
+    std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> waiters_{0};
+};
+
+// 自适应自旋：根据最近几次等待的结果决定休眠前自旋多久
+//
+// 等待在自旋阶段就结束时，把自旋上限调整为实际自旋次数的2倍(平滑后)；
+// 自旋落空而不得不休眠时，上限减半。这样短间隔的流量走纯自旋路径，
+// 长时间空闲的线程很快退化为几乎直接休眠。只由等待方线程访问。
+class AdaptiveSpin {
+ public:
+    static constexpr uint32_t kMinSpins = 16;
+    static constexpr uint32_t kMaxSpins = 1u << 16;
+
+    // 最多自旋limit()次等待ready()成立，成立返回true
+    template <typename Ready>
+    bool spin(Ready&& ready) noexcept {
+        for (uint32_t i = 0; i < limit_; ++i) {
+            if (ready()) {
+                uint32_t target = std::max(kMinSpins, std::min(kMaxSpins, 2 * (i + 1)));
+                limit_ = (limit_ * 7 + target) / 8;
+                return true;
+            }
+            ChanWait::cpu_relax();
+        }
+        limit_ = std::max(kMinSpins, limit_ / 2);
+        return false;
+    }
+
+    uint32_t limit() const noexcept { return limit_; }
+
+ private:
+    uint32_t limit_ = 1024;
+};
+
+namespace ChanFutex {
+    // 先自适应自旋，再按eventcount协议休眠，直到ready()成立
+    template <typename Ready>
+    static inline void await(EventCount& event, AdaptiveSpin& spinner, Ready&& ready) noexcept {
+        if (spinner.spin(ready)) {
+            return;
+        }
+        while (true) {
+            uint32_t key = event.prepare_wait();
+            if (ready()) {
+                event.cancel_wait();
+                return;
+            }
+            event.wait(key);
+            if (ready()) {
+                return;
+            }
+        }
+    }
+}
+
+#endif  // _PERF_TEST_CHAN_FUTEX_H_
@@ -0,0 +1,112 @@
+#ifndef _PERF_TEST_CHAN_LAYOUT_H_
+#define _PERF_TEST_CHAN_LAYOUT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+// 队列内存布局的编译期策略
+namespace ChanLayout {
+    // 槽位布局：决定第i个元素放在缓冲区的什么位置
+    //
+    // 每个策略提供Storage<T, Capacity, kCacheLineSize>：
+    // - slot(i) 返回第i个槽位的地址，槽位中的元素由队列用placement new构造
+    // - kContiguous 为true时槽位连续存放，批量拷贝、reserve/read_spans可以直接用
+    // - kSlotsPerLine 为每个缓存行放的元素数，0表示不按行分组
+    // - kPublishPerLine 为true时push_deferred/pop_deferred在写满/读完一行时发布索引
+
+    // 紧凑布局(默认)：槽位连续存放，int/uint64_t时一个缓存行里有多个槽位
+    struct SlotCompact {
+        static constexpr bool kContiguous = true;
+        static constexpr bool kPublishPerLine = false;
+
+        template <typename T, uint32_t Capacity, uint32_t kCacheLineSize>
+        struct Storage {
+            static constexpr size_t kSlotsPerLine = 0;
+
+            Storage() noexcept {}
+            ~Storage() {}
+
+            T* slot(size_t index) noexcept { return &values[index]; }
+            T* data() noexcept { return values; }
+
+            // 放在匿名union中，避免构造/析构队列时对所有槽位调用T的构造/析构函数
+            union {
+                alignas(kCacheLineSize) T values[Capacity];
+            };
+        };
+    };
+
+    // 分组布局：每个缓存行只放K个元素，剩余部分填充。
+    // 队列接近空时两端只会在同一组K个槽位上竞争，
+    // 配合push_deferred/pop_deferred按行发布，生产者写完一整行消费者才会读取
+    template <uint32_t K>
+    struct SlotGrouped {
+        static_assert(K >= 1, "SlotGrouped requires at least one slot per line");
+        static constexpr bool kContiguous = false;
+        static constexpr bool kPublishPerLine = K > 1;
+
+        template <typename T, uint32_t Capacity, uint32_t kCacheLineSize>
+        struct Storage {
+            static_assert(Capacity % K == 0, "Capacity must be a multiple of the slots per line");
+            static_assert(K == 1 || sizeof(T) * K <= kCacheLineSize,
+                          "K elements must fit in one cache line");
+            static constexpr size_t kSlotsPerLine = K;
+
+            struct alignas(kCacheLineSize) Line {
+                Line() noexcept {}
+                ~Line() {}
+
+                union {
+                    T values[K];
+                };
+            };
+
+            Storage() noexcept {}
+            ~Storage() {}
+
+            T* slot(size_t index) noexcept { return &lines[index / K].values[index % K]; }
+
+            Line lines[Capacity / K];
+        };
+    };
+
+    // 填充布局：每个槽位独占一个缓存行(元素大于一行时按行对齐)
+    using SlotPadded = SlotGrouped<1>;
+
+    // 索引布局：决定head_/tail_及各自本地副本(cached_tail_/cached_head_)的对齐方式
+    //
+    // 每个策略提供Align<kCacheLineSize>：
+    // - kIndex 为head_/tail_所在块的对齐，也用于索引之后的第一个字段，保证块之间不相邻
+    // - kCached 为本地副本等私有字段的对齐，0表示不额外对齐，紧跟在同一方的索引之后
+
+    // 分离布局(默认，即原有布局)：head_、cached_tail_、tail_、cached_head_各占一个缓存行
+    struct IndexSeparate {
+        template <uint32_t kCacheLineSize>
+        struct Align {
+            static constexpr size_t kIndex = kCacheLineSize;
+            static constexpr size_t kCached = kCacheLineSize;
+        };
+    };
+
+    // 按所有者分行：生产者一行(head_ + cached_tail_)，消费者一行(tail_ + cached_head_)。
+    // 每一方的快路径只访问自己的一行，对端只在本地副本失效时才来读这一行
+    struct IndexOwnerLine {
+        template <uint32_t kCacheLineSize>
+        struct Align {
+            static constexpr size_t kIndex = kCacheLineSize;
+            static constexpr size_t kCached = 0;
+        };
+    };
+
+    // 双行填充：按所有者分行，并且每一方的块按两个缓存行对齐。
+    // 相邻行预取器按128字节成对拉取，单行对齐时会顺带拉走对端的行
+    struct IndexDoubleLine {
+        template <uint32_t kCacheLineSize>
+        struct Align {
+            static constexpr size_t kIndex = 2 * kCacheLineSize;
+            static constexpr size_t kCached = 0;
+        };
+    };
+}
+
+#endif  // _PERF_TEST_CHAN_LAYOUT_H_
@@ -0,0 +1,185 @@
+#ifndef _PERF_TEST_CHAN_PERF_H_
+#define _PERF_TEST_CHAN_PERF_H_
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// 基准测试用的硬件性能计数器(perf_event_open)
+//
+// 每个线程打开一个计数器组，组内计数器同时调度，彼此之间的比例可信。
+// 容器、虚拟机或perf_event_paranoid限制下打不开时不报错：
+// 组长(cycles)打不开则整组不可用，其余计数器打不开(PMU不提供)则只缺这一项
+namespace ChanPerf {
+    enum Counter {
+        kCycles,
+        kInstructions,
+        kL1dMisses,      // L1D读未命中
+        kLlcMisses,      // 末级缓存未命中
+        kBranchMisses,
+        kHitm,           // 读到其他核心修改过的行(HITM snoop)，只在已知编码的PMU上打开
+        kCounterCount
+    };
+
+    static inline const char* counter_name(int counter) noexcept {
+        static const char* const kNames[kCounterCount] = {
+            "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "hitm"};
+        return kNames[counter];
+    }
+
+    // 一组计数器的读数，present[i]为false表示该计数器不可用
+    struct Counts {
+        double value[kCounterCount] = {};
+        bool present[kCounterCount] = {};
+
+        void add(const Counts& other) noexcept {
+            for (int i = 0; i < kCounterCount; ++i) {
+                value[i] += other.value[i];
+                present[i] = present[i] || other.present[i];
+            }
+        }
+
+        bool any() const noexcept {
+            for (int i = 0; i < kCounterCount; ++i) {
+                if (present[i]) return true;
+            }
+            return false;
+        }
+    };
+
+    // HITM的原始事件编码：Intel自Haswell起为0x04d2
+    // (MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM，Sapphire Rapids上称为XSNP_FWD)；
+    // 其他厂商没有对应的单一事件，返回0表示不打开
+    static inline uint64_t default_hitm_config() noexcept {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 9, "vendor_id") == 0) {
+                return line.find("GenuineIntel") != std::string::npos ? 0x04d2 : 0;
+            }
+        }
+        return 0;
+    }
+
+    class CounterGroup {
+     public:
+        // 为调用线程打开计数器组，只统计用户态；hitm_config为0时不打开HITM
+        explicit CounterGroup(uint64_t hitm_config) noexcept {
+            for (int i = 0; i < kCounterCount; ++i) {
+                fds_[i] = -1;
+            }
+#ifdef __linux__
+            open_counter(kCycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+            if (fds_[kCycles] < 0) {
+                return;
+            }
+            open_counter(kInstructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+            open_counter(kL1dMisses, PERF_TYPE_HW_CACHE,
+                         PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+            open_counter(kLlcMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            open_counter(kBranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+            if (hitm_config != 0) {
+                open_counter(kHitm, PERF_TYPE_RAW, hitm_config);
+            }
+#else
+            (void)hitm_config;
+            error_ = ENOSYS;
+#endif
+        }
+
+        ~CounterGroup() {
+#ifdef __linux__
+            for (int i = 0; i < kCounterCount; ++i) {
+                if (fds_[i] >= 0) {
+                    close(fds_[i]);
+                }
+            }
+#endif
+        }
+
+        CounterGroup(const CounterGroup&) = delete;
+        CounterGroup& operator=(const CounterGroup&) = delete;
+
+        // 组长是否打开成功；失败时error()为perf_event_open的errno
+        bool available() const noexcept { return fds_[kCycles] >= 0; }
+        int error() const noexcept { return error_; }
+
+        // 清零并开始计数
+        void start() noexcept {
+#ifdef __linux__
+            if (available()) {
+                ioctl(fds_[kCycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(fds_[kCycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+        }
+
+        void stop() noexcept {
+#ifdef __linux__
+            if (available()) {
+                ioctl(fds_[kCycles], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+        }
+
+        // 读取整组；计数器被复用(同时打开的事件多于硬件计数器)时按运行时间比例放大
+        Counts read() const noexcept {
+            Counts counts;
+#ifdef __linux__
+            if (!available()) {
+                return counts;
+            }
+            // 格式: nr, time_enabled, time_running, 按打开顺序的nr个值
+            uint64_t buffer[3 + kCounterCount] = {};
+            if (::read(fds_[kCycles], buffer, sizeof(buffer)) <= 0 || buffer[2] == 0) {
+                return counts;
+            }
+            double const scale = static_cast<double>(buffer[1]) / buffer[2];
+            uint64_t const* value = &buffer[3];
+            for (int i = 0; i < kCounterCount; ++i) {
+                if (fds_[i] >= 0) {
+                    counts.value[i] = *value++ * scale;
+                    counts.present[i] = true;
+                }
+            }
+#endif
+            return counts;
+        }
+
+     private:
+#ifdef __linux__
+        void open_counter(int counter, uint32_t type, uint64_t config) noexcept {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = counter == kCycles ? 1 : 0;   // 组长控制整组的启停
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int const leader = counter == kCycles ? -1 : fds_[kCycles];
+            int const fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0 && counter == kCycles) {
+                error_ = errno;
+            }
+            fds_[counter] = fd;
+        }
+#endif
+
+        int fds_[kCounterCount];
+        int error_ = 0;
+    };
+}
+
+#endif  // _PERF_TEST_CHAN_PERF_H_
@@ -0,0 +1,278 @@
+#ifndef _PERF_TEST_CHAN_POW2_H_
+#define _PERF_TEST_CHAN_POW2_H_
+
+#include <atomic>
+#include <type_traits>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include "chan_util.h"
+#include "chan_wait.h"
+#include "chan_clock.h"
+
+// 2的幂容量 + 64位单调递增序号的SPSC队列
+//
+// head_/tail_是从不回绕的64位计数器，槽位下标为 counter & kMask：
+// - push/pop中没有"到达容量就清零"的比较分支
+// - 满/空由 head - tail 直接判断，不需要保留一个空槽，所有槽位都可用
+// - size()是精确值，容量可以超过2^31个元素
+// WaitPolicy: 阻塞的push/pop在队列满/空时的等待策略，见chan_wait.h
+template <typename T, size_t Capacity, uint32_t kCacheLineSize = 64,
+          typename WaitPolicy = SpinWait>
+class SPSCQueuePow2 {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SPSCQueuePow2 requires a power-of-two capacity");
+
+ public:
+  // 使用placement new创建SPSC队列
+  static SPSCQueuePow2* create() noexcept {
+    void* raw_memory = operator new(sizeof(SPSCQueuePow2), std::align_val_t(kCacheLineSize),
+                                    std::nothrow);
+    if (!raw_memory) {
+      return nullptr;
+    }
+    return new(raw_memory) SPSCQueuePow2();
+  }
+
+  // 自定义删除函数
+  static void destroy(SPSCQueuePow2* queue) noexcept {
+    if (queue) {
+      // 清空所有元素
+      while (queue->front()) {
+        queue->pop();
+      }
+      queue->~SPSCQueuePow2();
+      operator delete(queue, std::align_val_t(kCacheLineSize));
+    }
+  }
+
+  template <typename... Args>
+  bool push(Args &&...args) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+
+    // 本地缓存的tail显示队列已满时，才重新读取共享的tail_
+    if (head - cached_tail_ == Capacity) {
+      WaitPolicy waiter;
+      while (head - (cached_tail_ = tail_.load(std::memory_order_acquire)) == Capacity) {
+        waiter.wait();
+      }
+    }
+
+    new (&buf_[head & kMask]) T(std::forward<Args>(args)...);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  // 非阻塞版本：队列满时立即返回false
+  template <typename... Args>
+  bool try_emplace(Args &&...args) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+
+    if (head - cached_tail_ == Capacity) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head - cached_tail_ == Capacity) {
+        return false;
+      }
+    }
+
+    new (&buf_[head & kMask]) T(std::forward<Args>(args)...);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_push(const T &value) noexcept {
+    return try_emplace(value);
+  }
+
+  bool try_push(T &&value) noexcept {
+    return try_emplace(std::move(value));
+  }
+
+  T *front() noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) {
+        return nullptr;
+      }
+    }
+    return &buf_[tail & kMask];
+  }
+
+  void pop() noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    buf_[tail & kMask].~T();
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+
+  // 阻塞出队：队列为空时按WaitPolicy等待
+  void pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+  }
+
+  // 限时入队：队列满时按WaitPolicy等待，超过截止时间仍满则返回false
+  template <typename Clock, typename Duration, typename... Args>
+  bool push_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                  Args &&...args) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+
+    if (head - cached_tail_ == Capacity) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (head - (cached_tail_ = tail_.load(std::memory_order_acquire)) == Capacity) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+
+    new (&buf_[head & kMask]) T(std::forward<Args>(args)...);
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  template <typename Rep, typename Period, typename... Args>
+  bool push_for(const std::chrono::duration<Rep, Period> &timeout, Args &&...args) noexcept {
+    return push_until(ChanClock::deadline_after(timeout), std::forward<Args>(args)...);
+  }
+
+  // 限时出队：队列空时按WaitPolicy等待，超过截止时间仍空则返回false
+  template <typename Clock, typename Duration>
+  bool pop_until(T &out, const std::chrono::time_point<Clock, Duration> &deadline) noexcept {
+    T *item = front();
+    if (!item) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+    return true;
+  }
+
+  template <typename Rep, typename Period>
+  bool pop_for(T &out, const std::chrono::duration<Rep, Period> &timeout) noexcept {
+    return pop_until(out, ChanClock::deadline_after(timeout));
+  }
+
+  // 非阻塞出队：队列为空时返回false
+  bool try_pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      return false;
+    }
+    out = std::move(*item);
+    pop();
+    return true;
+  }
+
+  // 批量入队：最多写入n个元素，返回实际写入的个数
+  size_t push_n(const T *items, size_t n) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (Capacity - (head - cached_tail_) < n) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    n = std::min<size_t>(n, Capacity - (head - cached_tail_));
+    if (n == 0) {
+      return 0;
+    }
+
+    ChanUtil::copy_into_ring(buf_, Capacity, head & kMask, items, n);
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // 批量出队：最多取出max个元素到out，返回实际取出的个数
+  size_t pop_n(T *out, size_t max) noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (cached_head_ - tail < max) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    size_t const n = std::min<size_t>(max, cached_head_ - tail);
+    if (n == 0) {
+      return 0;
+    }
+
+    ChanUtil::move_from_ring(buf_, Capacity, tail & kMask, out, n);
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  // 零拷贝写入：返回最多n个可写槽位，之后调用commit(k)发布
+  ChanUtil::RingSpans<T> reserve(size_t n) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (Capacity - (head - cached_tail_) < n) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    n = std::min<size_t>(n, Capacity - (head - cached_tail_));
+    return ChanUtil::make_spans(buf_, Capacity, head & kMask, n);
+  }
+
+  void commit(size_t k) noexcept {
+    head_.store(head_.load(std::memory_order_relaxed) + k, std::memory_order_release);
+  }
+
+  // 零拷贝读取：返回当前所有可读元素，之后调用release(k)消费
+  ChanUtil::RingSpans<T> read_spans() noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    cached_head_ = head_.load(std::memory_order_acquire);
+    return ChanUtil::make_spans(buf_, Capacity, tail & kMask, cached_head_ - tail);
+  }
+
+  void release(size_t k) noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    ChanUtil::destroy_in_ring(buf_, Capacity, tail & kMask, k);
+    tail_.store(tail + k, std::memory_order_release);
+  }
+
+  // 精确的元素个数：先读tail再读head，保证结果不会超过Capacity
+  size_t size() const noexcept {
+    auto const tail = tail_.load(std::memory_order_acquire);
+    auto const head = head_.load(std::memory_order_acquire);
+    return static_cast<size_t>(head - tail);
+  }
+
+  size_t capacity() const noexcept {
+    return Capacity;
+  }
+
+ private:
+  static constexpr uint64_t kMask = Capacity - 1;
+
+  SPSCQueuePow2() noexcept {}
+  ~SPSCQueuePow2() {}
+
+  // 禁止拷贝和移动
+  SPSCQueuePow2(const SPSCQueuePow2&) = delete;
+  SPSCQueuePow2& operator=(const SPSCQueuePow2&) = delete;
+  SPSCQueuePow2(SPSCQueuePow2&&) = delete;
+  SPSCQueuePow2& operator=(SPSCQueuePow2&&) = delete;
+
+  // 生产者写head_，并在独立的缓存行上保存tail_的本地副本
+  alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+  alignas(kCacheLineSize) uint64_t cached_tail_ = 0;
+
+  // 消费者写tail_，并在独立的缓存行上保存head_的本地副本
+  alignas(kCacheLineSize) std::atomic<uint64_t> tail_{0};
+  alignas(kCacheLineSize) uint64_t cached_head_ = 0;
+
+  union {
+    alignas(kCacheLineSize) T buf_[Capacity];
+  };
+};
+
+#endif  // _PERF_TEST_CHAN_POW2_H_
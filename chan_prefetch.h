@@ -0,0 +1,61 @@
+#ifndef _PERF_TEST_CHAN_PREFETCH_H_
+#define _PERF_TEST_CHAN_PREFETCH_H_
+
+#include <cstdint>
+#if defined(__CLDEMOTE__)
+#include <immintrin.h>
+#endif
+
+// 软件预取策略：环大于L2时，消费者读取tail槽位、生产者写入head槽位(RFO)都会未命中，
+// 两端提前若干个缓存行发出预取，把未命中藏在前面几次操作的时间里
+namespace ChanPrefetch {
+    // 读预取：消费者提前把将要读取的行拉进L1
+    static inline void read(const void* addr) noexcept {
+        __builtin_prefetch(addr, 0, 3);
+    }
+
+    // 写意图预取：直接以独占状态取得将要写入的行，省掉写入时的RFO
+    static inline void write_intent(const void* addr) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        // prefetchw在不支持的老处理器上按NOP执行，可以无条件使用
+        __asm__ __volatile__("prefetchw %0" : : "m"(*static_cast<const char*>(addr)));
+#else
+        // AArch64上生成 prfm pstl1keep
+        __builtin_prefetch(addr, 1, 3);
+#endif
+    }
+
+    // 编译器是否提供了cldemote(-mcldemote或支持它的-march)
+#if defined(__CLDEMOTE__)
+    static constexpr bool kDemoteAvailable = true;
+#else
+    static constexpr bool kDemoteAvailable = false;
+#endif
+
+    // 行降级提示：生产者写完一行后把它从私有缓存推到共享的LLC，消费者读取时不必跨核取行
+    static inline void demote(const void* addr) noexcept {
+#if defined(__CLDEMOTE__)
+        _cldemote(const_cast<void*>(addr));
+#else
+        (void)addr;
+#endif
+    }
+
+    // 不预取(默认)
+    struct None {
+        static constexpr uint32_t kConsumerLines = 0;
+        static constexpr uint32_t kProducerLines = 0;
+        static constexpr bool kDemote = false;
+    };
+
+    // 消费者提前ConsumerLines个缓存行读预取，生产者提前ProducerLines个缓存行写意图预取；
+    // Demote为true且编译器提供cldemote时，生产者每写完一行就降级这一行
+    template <uint32_t ConsumerLines, uint32_t ProducerLines = ConsumerLines, bool Demote = false>
+    struct Ahead {
+        static constexpr uint32_t kConsumerLines = ConsumerLines;
+        static constexpr uint32_t kProducerLines = ProducerLines;
+        static constexpr bool kDemote = Demote && kDemoteAvailable;
+    };
+}
+
+#endif  // _PERF_TEST_CHAN_PREFETCH_H_
@@ -0,0 +1,364 @@
+#ifndef _PERF_TEST_CHAN_SHM_H_
+#define _PERF_TEST_CHAN_SHM_H_
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "chan_clock.h"
+#include "chan_wait.h"
+
+// 跨进程SPSC队列：整个队列对象放在POSIX共享内存(shm_open + mmap)中
+//
+// 对象内部只有定长字段和内联数组，没有指针，因此与各进程的映射地址无关。
+// 共享内存开头是带魔数和版本号的头部，attach时校验元素大小、容量和缓存行大小，
+// 不同编译配置的进程不会误用同一块内存。head_/tail_以及各自的本地缓存
+// 与SPSCQueueSoftArray一样分布在独立的缓存行上，快路径完全相同。
+//
+// 崩溃检测与恢复：生产者/消费者通过register_role()登记自己的pid，
+// peer_alive()用kill(pid, 0)(排除僵尸进程)和可选的心跳超时判断对端是否存活；
+// 对端进程消失后，新进程可以接管该角色。已发布的数据只通过一次release store
+// 对外可见，崩溃的生产者不会留下半条消息；消费者用front()处理完再pop()，
+// 接管后从上次pop的位置继续，最多重复处理崩溃时正在处理的那一条。
+template <typename T, uint32_t Capacity, uint32_t kCacheLineSize = 64,
+          typename WaitPolicy = SpinWait>
+class SPSCQueueShm {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "SPSCQueueShm elements cross process boundaries and must be trivially copyable");
+  static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                std::atomic<uint64_t>::is_always_lock_free,
+                "SPSCQueueShm requires address-free (lock-free) atomics");
+  static_assert(Capacity >= 2, "SPSCQueueShm requires a capacity of at least 2");
+
+ public:
+  enum class Role : uint32_t { kProducer, kConsumer };
+
+  static constexpr uint64_t kMagic = 0x5350534353484d51ull;  // "SPSCSHMQ"
+  static constexpr uint32_t kVersion = 1;
+
+  // 创建名为name的共享内存队列(name形如"/my_queue")，同名对象已存在时返回nullptr
+  static SPSCQueueShm* create_shared(const char* name) noexcept {
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      return nullptr;
+    }
+    if (ftruncate(fd, sizeof(SPSCQueueShm)) != 0) {
+      close(fd);
+      shm_unlink(name);
+      return nullptr;
+    }
+    void* raw_memory = mmap(nullptr, sizeof(SPSCQueueShm), PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+    close(fd);
+    if (raw_memory == MAP_FAILED) {
+      shm_unlink(name);
+      return nullptr;
+    }
+
+    // ftruncate保证内存全为0，构造完成后最后发布state_，attach方据此判断初始化完成
+    SPSCQueueShm* queue = new(raw_memory) SPSCQueueShm();
+    queue->state_.store(kReady, std::memory_order_release);
+    return queue;
+  }
+
+  // 映射已存在的共享内存队列；不存在、初始化超时或头部与本进程的模板参数不一致时返回nullptr
+  static SPSCQueueShm* attach(const char* name,
+                              std::chrono::milliseconds timeout = std::chrono::milliseconds(1000)) noexcept {
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+      return nullptr;
+    }
+
+    // 创建方可能还没来得及ftruncate
+    auto const deadline = ChanClock::deadline_after(timeout);
+    struct stat st;
+    int stat_result;
+    while ((stat_result = fstat(fd, &st)) == 0 && st.st_size == 0 &&
+           std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    if (stat_result != 0 || st.st_size != static_cast<off_t>(sizeof(SPSCQueueShm))) {
+      close(fd);
+      return nullptr;
+    }
+
+    void* raw_memory = mmap(nullptr, sizeof(SPSCQueueShm), PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+    close(fd);
+    if (raw_memory == MAP_FAILED) {
+      return nullptr;
+    }
+
+    SPSCQueueShm* queue = static_cast<SPSCQueueShm*>(raw_memory);
+    while (queue->state_.load(std::memory_order_acquire) != kReady) {
+      if (std::chrono::steady_clock::now() >= deadline) {
+        munmap(raw_memory, sizeof(SPSCQueueShm));
+        return nullptr;
+      }
+      std::this_thread::yield();
+    }
+    if (!queue->header_matches()) {
+      munmap(raw_memory, sizeof(SPSCQueueShm));
+      return nullptr;
+    }
+    return queue;
+  }
+
+  // 解除本进程的映射，不影响其他进程
+  static void detach(SPSCQueueShm* queue) noexcept {
+    if (queue) {
+      munmap(queue, sizeof(SPSCQueueShm));
+    }
+  }
+
+  // 删除共享内存名字；已映射的进程在detach之前仍可继续使用
+  static void unlink(const char* name) noexcept {
+    shm_unlink(name);
+  }
+
+  // 登记本进程为role。该角色空闲、已属于本进程，或原持有者进程已不存在
+  // (以及stale_after非0时心跳超时)时成功；接管崩溃的对端会递增generation()。
+  // 崩溃进程的pid可能被系统复用，需要可靠检测时让两端定期heartbeat()并传入stale_after。
+  // 已退出但未被父进程回收的僵尸进程仍能通过kill(pid, 0)，这里另外读取/proc/<pid>/stat识别；
+  // 没有/proc时(非Linux或未挂载)无法识别，同样需要stale_after
+  bool register_role(Role role, std::chrono::nanoseconds stale_after = std::chrono::nanoseconds(0)) noexcept {
+    RoleState const state = role_state(role);
+    int32_t const self = static_cast<int32_t>(getpid());
+    int32_t owner = state.pid->load(std::memory_order_acquire);
+    while (true) {
+      if (owner != 0 && owner != self && owner_alive(state, owner, stale_after)) {
+        return false;
+      }
+      if (state.pid->compare_exchange_weak(owner, self, std::memory_order_acq_rel)) {
+        break;
+      }
+    }
+    if (owner != 0 && owner != self) {
+      generation_.fetch_add(1, std::memory_order_acq_rel);
+    }
+    heartbeat(role);
+    return true;
+  }
+
+  // 正常退出时释放角色，对端的peer_alive()随即返回false
+  void release_role(Role role) noexcept {
+    int32_t self = static_cast<int32_t>(getpid());
+    role_state(role).pid->compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+  }
+
+  // 刷新本角色的心跳时间戳(CLOCK_MONOTONIC在同一台机器的进程间可比)
+  void heartbeat(Role role) noexcept {
+    role_state(role).heartbeat_ns->store(monotonic_ns(), std::memory_order_release);
+  }
+
+  // 站在self的角度检查对端：已登记、进程存在，且(stale_after非0时)心跳未超时
+  bool peer_alive(Role self, std::chrono::nanoseconds stale_after = std::chrono::nanoseconds(0)) noexcept {
+    RoleState const state = role_state(self == Role::kProducer ? Role::kConsumer : Role::kProducer);
+    int32_t owner = state.pid->load(std::memory_order_acquire);
+    return owner != 0 && owner_alive(state, owner, stale_after);
+  }
+
+  // 角色被接管的次数
+  uint32_t generation() const noexcept {
+    return generation_.load(std::memory_order_acquire);
+  }
+
+  // 阻塞入队：队列满时按WaitPolicy等待
+  bool push(const T &value) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const next_head = next_index(head);
+
+    if (next_head == cached_tail_) {
+      WaitPolicy waiter;
+      while (next_head == (cached_tail_ = tail_.load(std::memory_order_acquire))) {
+        waiter.wait();
+      }
+    }
+
+    buf_[head] = value;
+    head_.store(next_head, std::memory_order_release);
+    return true;
+  }
+
+  // 非阻塞入队：队列满时返回false
+  bool try_push(const T &value) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const next_head = next_index(head);
+
+    if (next_head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (next_head == cached_tail_) {
+        return false;
+      }
+    }
+
+    buf_[head] = value;
+    head_.store(next_head, std::memory_order_release);
+    return true;
+  }
+
+  T *front() noexcept {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) {
+        return nullptr;
+      }
+    }
+    return &buf_[tail];
+  }
+
+  void pop() noexcept {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(next_index(tail), std::memory_order_release);
+  }
+
+  // 阻塞出队：队列为空时按WaitPolicy等待
+  void pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        waiter.wait();
+      }
+    }
+    out = *item;
+    pop();
+  }
+
+  bool try_pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      return false;
+    }
+    out = *item;
+    pop();
+    return true;
+  }
+
+  size_t size() const noexcept {
+    auto const head = head_.load(std::memory_order_acquire);
+    auto const tail = tail_.load(std::memory_order_acquire);
+    return head >= tail ? head - tail : Capacity - tail + head;
+  }
+
+  size_t capacity() const noexcept {
+    return Capacity - 1;
+  }
+
+ private:
+  static constexpr uint32_t kReady = 1;
+
+  // 指向某个角色的pid和心跳字段，字段本身位于该角色独占的缓存行上
+  struct RoleState {
+    std::atomic<int32_t>* pid;
+    std::atomic<uint64_t>* heartbeat_ns;
+  };
+
+  SPSCQueueShm() noexcept
+      : magic_(kMagic), version_(kVersion), element_size_(sizeof(T)), capacity_(Capacity),
+        cache_line_size_(kCacheLineSize), total_size_(sizeof(SPSCQueueShm)) {}
+
+  // 禁止拷贝和移动
+  SPSCQueueShm(const SPSCQueueShm&) = delete;
+  SPSCQueueShm& operator=(const SPSCQueueShm&) = delete;
+  SPSCQueueShm(SPSCQueueShm&&) = delete;
+  SPSCQueueShm& operator=(SPSCQueueShm&&) = delete;
+
+  bool header_matches() const noexcept {
+    return magic_ == kMagic && version_ == kVersion && element_size_ == sizeof(T) &&
+           capacity_ == Capacity && cache_line_size_ == kCacheLineSize &&
+           total_size_ == sizeof(SPSCQueueShm);
+  }
+
+  RoleState role_state(Role role) noexcept {
+    if (role == Role::kProducer) {
+      return {&producer_pid_, &producer_heartbeat_ns_};
+    }
+    return {&consumer_pid_, &consumer_heartbeat_ns_};
+  }
+
+  static bool owner_alive(const RoleState& state, int32_t owner,
+                          std::chrono::nanoseconds stale_after) noexcept {
+    // EPERM说明进程存在但属于其他用户
+    if ((kill(owner, 0) != 0 && errno == ESRCH) || is_zombie(owner)) {
+      return false;
+    }
+    if (stale_after.count() > 0) {
+      uint64_t last = state.heartbeat_ns->load(std::memory_order_acquire);
+      if (monotonic_ns() - last > static_cast<uint64_t>(stale_after.count())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // /proc/<pid>/stat的格式为 "pid (comm) state ..."，comm里可能有')'，取最后一个；
+  // 读取失败时按未退出处理
+  static bool is_zombie(int32_t pid) noexcept {
+    char path[32];
+    std::snprintf(path, sizeof(path), "/proc/%d/stat", static_cast<int>(pid));
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return false;
+    }
+    char buffer[256];
+    ssize_t const size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (size <= 0) {
+      return false;
+    }
+    buffer[size] = '\0';
+    char const* end = std::strrchr(buffer, ')');
+    return end && end[1] == ' ' && (end[2] == 'Z' || end[2] == 'X');
+  }
+
+  static uint64_t monotonic_ns() noexcept {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+  }
+
+  static uint32_t next_index(uint32_t index) noexcept {
+    return index + 1 == Capacity ? 0 : index + 1;
+  }
+
+  // 版本化头部：只在创建时写入一次，之后只读
+  alignas(kCacheLineSize) uint64_t magic_;
+  uint32_t version_;
+  uint32_t element_size_;
+  uint32_t capacity_;
+  uint32_t cache_line_size_;
+  uint64_t total_size_;
+  std::atomic<uint32_t> state_{0};
+  std::atomic<uint32_t> generation_{0};
+
+  alignas(kCacheLineSize) std::atomic<uint32_t> head_{0};
+  // 生产者独占：tail_的本地缓存和生产者的登记信息
+  alignas(kCacheLineSize) uint32_t cached_tail_ = 0;
+  std::atomic<int32_t> producer_pid_{0};
+  std::atomic<uint64_t> producer_heartbeat_ns_{0};
+
+  alignas(kCacheLineSize) std::atomic<uint32_t> tail_{0};
+  // 消费者独占：head_的本地缓存和消费者的登记信息
+  alignas(kCacheLineSize) uint32_t cached_head_ = 0;
+  std::atomic<int32_t> consumer_pid_{0};
+  std::atomic<uint64_t> consumer_heartbeat_ns_{0};
+
+  union {
+    alignas(kCacheLineSize) T buf_[Capacity];
+  };
+};
+
+#endif  // _PERF_TEST_CHAN_SHM_H_
@@ -0,0 +1,258 @@
+#ifndef _PERF_TEST_CHAN_SLOT_SEQ_H_
+#define _PERF_TEST_CHAN_SLOT_SEQ_H_
+
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include "chan_wait.h"
+#include "chan_clock.h"
+
+// 槽位序号SPSC队列 (FastForward / B-Queue 风格)
+//
+// 生产者和消费者之间没有共享的head_/tail_索引，每个槽位带一个序号，与数据写在一起：
+// - 槽位 p & kMask 的序号等于 p 表示空闲、可写入第p个元素；
+//   等于 p + 1 表示第p个元素已写入、可以读取
+// - 生产者写完数据后release store序号为 p + 1；
+//   消费者读完、析构后release store序号为 p + Capacity，即下一圈的空闲
+// - 两端的位置计数器都是各自私有的，双方只共享数据所在的缓存行，从不共享索引行
+// - 生产者按B-Queue的方式向前探测：位置 p + kProbeSlots - 1 已空闲时，
+//   它之前的槽位必然都已空闲(消费者按顺序释放)，接下来这一段不再读取槽位序号
+// 代价是每个槽位多一个32位序号，加上对齐填充后实际多占slot_overhead()字节
+// (T按8字节对齐时为8字节，不止4字节)；两端距离很近时会在同一数据行上来回传递，
+// 大消息或能保持一定距离的负载更适合这种设计
+// WaitPolicy: 阻塞的push/pop在队列满/空时的等待策略，见chan_wait.h
+template <typename T, size_t Capacity, uint32_t kCacheLineSize = 64,
+          typename WaitPolicy = SpinWait>
+class SPSCQueueSlotSeq {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SPSCQueueSlotSeq requires a power-of-two capacity");
+  static_assert(Capacity <= (size_t(1) << 31),
+                "SPSCQueueSlotSeq uses 32-bit slot sequences");
+
+ public:
+  // 使用placement new创建SPSC队列
+  static SPSCQueueSlotSeq* create() noexcept {
+    void* raw_memory = operator new(sizeof(SPSCQueueSlotSeq), std::align_val_t(kCacheLineSize),
+                                    std::nothrow);
+    if (!raw_memory) {
+      return nullptr;
+    }
+    return new(raw_memory) SPSCQueueSlotSeq();
+  }
+
+  // 自定义删除函数
+  static void destroy(SPSCQueueSlotSeq* queue) noexcept {
+    if (queue) {
+      // 清空所有元素
+      while (queue->front()) {
+        queue->pop();
+      }
+      queue->~SPSCQueueSlotSeq();
+      operator delete(queue, std::align_val_t(kCacheLineSize));
+    }
+  }
+
+  template <typename... Args>
+  bool push(Args &&...args) noexcept {
+    if (head_ == free_until_ && !probe_free()) {
+      WaitPolicy waiter;
+      while (!probe_free()) {
+        waiter.wait();
+      }
+    }
+    emplace_at_head(std::forward<Args>(args)...);
+    return true;
+  }
+
+  // 非阻塞版本：队列满时立即返回false
+  template <typename... Args>
+  bool try_emplace(Args &&...args) noexcept {
+    if (head_ == free_until_ && !probe_free()) {
+      return false;
+    }
+    emplace_at_head(std::forward<Args>(args)...);
+    return true;
+  }
+
+  bool try_push(const T &value) noexcept {
+    return try_emplace(value);
+  }
+
+  bool try_push(T &&value) noexcept {
+    return try_emplace(std::move(value));
+  }
+
+  // 只读取当前槽位的序号，不读取生产者的任何状态
+  T *front() noexcept {
+    Slot &slot = slots_[tail_ & kMask];
+    if (slot.seq.load(std::memory_order_acquire) != static_cast<uint32_t>(tail_ + 1)) {
+      return nullptr;
+    }
+    return &slot.value;
+  }
+
+  void pop() noexcept {
+    Slot &slot = slots_[tail_ & kMask];
+    slot.value.~T();
+    slot.seq.store(static_cast<uint32_t>(tail_ + Capacity), std::memory_order_release);
+    ++tail_;
+  }
+
+  // 阻塞出队：队列为空时按WaitPolicy等待
+  void pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+  }
+
+  // 限时入队：队列满时按WaitPolicy等待，超过截止时间仍满则返回false
+  template <typename Clock, typename Duration, typename... Args>
+  bool push_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                  Args &&...args) noexcept {
+    if (head_ == free_until_ && !probe_free()) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (!probe_free()) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+    emplace_at_head(std::forward<Args>(args)...);
+    return true;
+  }
+
+  template <typename Rep, typename Period, typename... Args>
+  bool push_for(const std::chrono::duration<Rep, Period> &timeout, Args &&...args) noexcept {
+    return push_until(ChanClock::deadline_after(timeout), std::forward<Args>(args)...);
+  }
+
+  // 限时出队：队列空时按WaitPolicy等待，超过截止时间仍空则返回false
+  template <typename Clock, typename Duration>
+  bool pop_until(T &out, const std::chrono::time_point<Clock, Duration> &deadline) noexcept {
+    T *item = front();
+    if (!item) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+    return true;
+  }
+
+  template <typename Rep, typename Period>
+  bool pop_for(T &out, const std::chrono::duration<Rep, Period> &timeout) noexcept {
+    return pop_until(out, ChanClock::deadline_after(timeout));
+  }
+
+  // 非阻塞出队：队列为空时返回false
+  bool try_pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      return false;
+    }
+    out = std::move(*item);
+    pop();
+    return true;
+  }
+
+  // 每个槽位比T多占的字节数：序号加上对齐填充
+  static constexpr size_t slot_overhead() noexcept {
+    return sizeof(Slot) - sizeof(T);
+  }
+
+  size_t capacity() const noexcept {
+    return Capacity;
+  }
+
+  // 获取队列类型名称，用于测试识别
+  static const char* queue_type() {
+    return "SPSCQueueSlotSeq";
+  }
+
+ private:
+  static constexpr uint64_t kMask = Capacity - 1;
+
+  // 槽位：序号和数据相邻，通常落在同一个缓存行里，消费者一次未命中即可拿到两者
+  struct Slot {
+    std::atomic<uint32_t> seq;
+    union {
+      T value;
+    };
+
+    Slot() noexcept {}
+    ~Slot() {}
+  };
+
+  // 生产者一次向前探测的槽位数：跨过约4个缓存行，避开消费者正在读取的行
+  static constexpr uint64_t kProbeSlots = std::max<uint64_t>(
+      1, std::min<uint64_t>(Capacity / 2, 4 * kCacheLineSize / sizeof(Slot)));
+
+  // 初始时槽位i的序号为i，即第i个元素可以直接写入
+  SPSCQueueSlotSeq() noexcept {
+    for (size_t i = 0; i < Capacity; ++i) {
+      slots_[i].seq.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+    }
+  }
+
+  ~SPSCQueueSlotSeq() {}
+
+  // 禁止拷贝和移动
+  SPSCQueueSlotSeq(const SPSCQueueSlotSeq&) = delete;
+  SPSCQueueSlotSeq& operator=(const SPSCQueueSlotSeq&) = delete;
+  SPSCQueueSlotSeq(SPSCQueueSlotSeq&&) = delete;
+  SPSCQueueSlotSeq& operator=(SPSCQueueSlotSeq&&) = delete;
+
+  bool slot_free(uint64_t position) const noexcept {
+    return slots_[position & kMask].seq.load(std::memory_order_acquire) ==
+           static_cast<uint32_t>(position);
+  }
+
+  // 已知空闲的槽位用完后调用：先探测一整段，失败时只检查当前槽位
+  bool probe_free() noexcept {
+    if (slot_free(head_ + kProbeSlots - 1)) {
+      free_until_ = head_ + kProbeSlots;
+      return true;
+    }
+    if (slot_free(head_)) {
+      free_until_ = head_ + 1;
+      return true;
+    }
+    return false;
+  }
+
+  template <typename... Args>
+  void emplace_at_head(Args &&...args) noexcept {
+    Slot &slot = slots_[head_ & kMask];
+    new (&slot.value) T(std::forward<Args>(args)...);
+    slot.seq.store(static_cast<uint32_t>(head_ + 1), std::memory_order_release);
+    ++head_;
+  }
+
+  // 生产者私有：下一个写入位置，以及已确认空闲的位置上界
+  alignas(kCacheLineSize) uint64_t head_ = 0;
+  uint64_t free_until_ = 0;
+
+  // 消费者私有：下一个读取位置
+  alignas(kCacheLineSize) uint64_t tail_ = 0;
+
+  alignas(kCacheLineSize) Slot slots_[Capacity];
+};
+
+#endif  // _PERF_TEST_CHAN_SLOT_SEQ_H_
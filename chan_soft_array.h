@@ -9,8 +9,27 @@
 #include <iostream>
 #include <new>
 #include <cstdint>
+#include "chan_util.h"
+#include "chan_wait.h"
+#include "chan_futex.h"
+#include "chan_clock.h"
+#include "chan_alloc.h"
+#include "chan_layout.h"
+#include "chan_prefetch.h"
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
 
-template <typename T, uint32_t Capacity, uint32_t kCacheLineSize = 64>
+// WaitPolicy: 阻塞的push/pop在队列满/空时的等待策略，见chan_wait.h
+// SlotLayout: 槽位布局(紧凑/按行分组/每槽一行)，见chan_layout.h；
+// 非紧凑布局下reserve/read_spans/release不可用，push_n/pop_n逐个拷贝
+// IndexLayout: head_/tail_及其本地副本的布局(分离/按所有者分行/双行填充)，见chan_layout.h
+// PrefetchPolicy: 单元素push/pop的软件预取和行降级策略，见chan_prefetch.h
+template <typename T, uint32_t Capacity, uint32_t kCacheLineSize = 64,
+          typename WaitPolicy = SpinWait, typename SlotLayout = ChanLayout::SlotCompact,
+          typename IndexLayout = ChanLayout::IndexSeparate,
+          typename PrefetchPolicy = ChanPrefetch::None>
 class SPSCQueueSoftArray {
  public:
   // 使用placement new创建SPSC队列
@@ -18,8 +37,9 @@ class SPSCQueueSoftArray {
     // 计算需要的总内存大小
     size_t total_size = sizeof(SPSCQueueSoftArray);
     
-    // 分配内存，确保对齐
-    void* raw_memory = operator new(total_size, std::align_val_t(kCacheLineSize));
+    // 按对象自身的对齐分配(IndexDoubleLine时为两个缓存行，大于kCacheLineSize)
+    void* raw_memory = operator new(total_size, std::align_val_t(alignof(SPSCQueueSoftArray)),
+                                    std::nothrow);
     if (!raw_memory) {
       return nullptr;
     }
@@ -28,58 +48,499 @@ class SPSCQueueSoftArray {
     SPSCQueueSoftArray* queue = new(raw_memory) SPSCQueueSoftArray();
     return queue;
   }
+
+  // 按options用mmap分配队列内存(可选大页、NUMA放置)，见chan_alloc.h；
+  // 实际使用的页面类型可能因系统预留不足而退化，可通过page_size()查询。
+  // NUMA放置时，生产者/消费者索引行所在的页不与对端共享时(例如kCacheLineSize为4096)，
+  // 还会分别绑定到各自一侧的节点
+  static SPSCQueueSoftArray* create(const ChanAlloc::Options& options) noexcept {
+    ChanAlloc::Options resolved = options;
+#ifdef __linux__
+    ChanAlloc::resolve_nodes(resolved);
+#endif
+    ChanAlloc::Allocation allocation;
+    void* raw_memory = ChanAlloc::allocate(sizeof(SPSCQueueSoftArray), alignof(SPSCQueueSoftArray),
+                                           resolved, allocation);
+    if (!raw_memory) {
+      return nullptr;
+    }
+
+    SPSCQueueSoftArray* queue = new(raw_memory) SPSCQueueSoftArray();
+    queue->allocation_ = allocation;
+#ifdef __linux__
+    if (allocation.numa_bound) {
+      ChanAlloc::bind_owned_pages(&queue->head_, &queue->tail_, &queue->tail_, &queue->not_empty_,
+                                  resolved.producer_node);
+      ChanAlloc::bind_owned_pages(&queue->tail_, &queue->not_empty_, &queue->head_, &queue->tail_,
+                                  resolved.consumer_node);
+    }
+#endif
+    return queue;
+  }
   
   // 自定义删除函数
   static void destroy(SPSCQueueSoftArray* queue) noexcept {
     if (queue) {
-      // 清空所有元素
+      // 先发布延迟的head_/tail_，再清空所有元素
+      queue->flush();
+      queue->flush_tail();
       while (queue->front()) {
         queue->pop();
       }
       
+#ifdef __linux__
+      if (queue->notify_fd_ >= 0) {
+        close(queue->notify_fd_);
+      }
+#endif
+
+      // 析构前取出分配记录，决定用哪种方式释放
+      ChanAlloc::Allocation const allocation = queue->allocation_;
+
       // 调用析构函数
       queue->~SPSCQueueSoftArray();
       
       // 释放内存
-      operator delete(queue, std::align_val_t(kCacheLineSize));
+      if (allocation.base) {
+        ChanAlloc::release(allocation);
+      } else {
+        operator delete(queue, std::align_val_t(alignof(SPSCQueueSoftArray)));
+      }
     }
   }
 
   template <typename... Args>
   bool push(Args &&...args) noexcept {
     auto const head = head_.load(std::memory_order_relaxed);
-    auto next_head = head + 1;
-    if (next_head == Capacity) {
-      next_head = 0;
-    }
+    auto const next_head = next_index(head);
 
-    // 如果队列满了，忙等待
-    while (next_head == tail_.load(std::memory_order_acquire)) {
-      // nothing
+    // 本地缓存的tail显示队列已满时，才重新读取共享的tail_，
+    // 避免每次push都去拉取消费者所在的缓存行；仍然满则按WaitPolicy等待
+    if (next_head == cached_tail_) {
+      WaitPolicy waiter;
+      while (next_head == (cached_tail_ = tail_.load(std::memory_order_acquire))) {
+        waiter.wait();
+      }
     }
 
     // 使用placement new构造元素
-    new (&buf_[head]) T(std::forward<Args>(args)...);
-    head_.store(next_head, std::memory_order_release);
+    new (slot(head)) T(std::forward<Args>(args)...);
+    after_produce(head, next_head);
+    publish_head(next_head);
     return true;
   }
 
+  // 非阻塞版本：队列满时立即返回false，由调用方决定丢弃或转移
+  template <typename... Args>
+  bool try_emplace(Args &&...args) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const next_head = next_index(head);
+
+    if (next_head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (next_head == cached_tail_) {
+        return false;
+      }
+    }
+
+    new (slot(head)) T(std::forward<Args>(args)...);
+    after_produce(head, next_head);
+    publish_head(next_head);
+    return true;
+  }
+
+  bool try_push(const T &value) noexcept {
+    return try_emplace(value);
+  }
+
+  bool try_push(T &&value) noexcept {
+    return try_emplace(std::move(value));
+  }
+
+  // 延迟发布入队：元素写入槽位后暂不发布head_，累计publish_interval()个、
+  // 或距第一个未发布元素超过set_publish_deadline()设定的时长后才一次性发布，
+  // 减少消费者缓存行被失效的次数，代价是消费者要晚一些才看到这些元素。
+  // 时长只在生产者调用push_deferred/flush_if_stale()时检查，生产者不调用就不会发布，
+  // 因此它不是滞留时间的上限：两次push_deferred之间做其他事情时应定期调用flush_if_stale()，
+  // 空闲或改用其他push接口之前必须调用flush()。
+  // 按行分组的SlotLayout下，写满一个缓存行的槽位时也会发布，默认间隔为每行元素数
+  template <typename... Args>
+  void push_deferred(Args &&...args) noexcept {
+    auto const head = pending_count_ ? unpublished_head_ : head_.load(std::memory_order_relaxed);
+    auto const next_head = next_index(head);
+
+    if (next_head == cached_tail_) {
+      // 队列已满：先发布全部已写入的元素，否则消费者看不到它们，两端会互相等待；
+      // 等待期间不再有未发布的元素，无需再按时长检查
+      flush();
+      WaitPolicy waiter;
+      while (next_head == (cached_tail_ = tail_.load(std::memory_order_acquire))) {
+        waiter.wait();
+      }
+    }
+
+    new (slot(head)) T(std::forward<Args>(args)...);
+    after_produce(head, next_head);
+    unpublished_head_ = next_head;
+    if (pending_count_++ == 0 && publish_deadline_ticks_) {
+      first_pending_ticks_ = ChanClock::ticks();
+    }
+    if (pending_count_ >= publish_interval_ || completes_line(next_head)) {
+      flush();
+    } else {
+      flush_if_stale();
+    }
+  }
+
+  // 第一个未发布元素已滞留超过set_publish_deadline()设定的时长时发布，返回是否发布了；
+  // 未设定时长或没有未发布元素时只是一次分支
+  bool flush_if_stale() noexcept {
+    if (pending_count_ && publish_deadline_ticks_ &&
+        ChanClock::ticks() - first_pending_ticks_ >= publish_deadline_ticks_) {
+      flush();
+      return true;
+    }
+    return false;
+  }
+
+  // 立即发布push_deferred写入但尚未发布的元素
+  void flush() noexcept {
+    if (pending_count_) {
+      pending_count_ = 0;
+      publish_head(unpublished_head_);
+    }
+  }
+
+  // 每n次push_deferred发布一次head_，n为1时与push相同
+  void set_publish_interval(uint32_t n) noexcept {
+    publish_interval_ = n ? n : 1;
+  }
+
+  uint32_t publish_interval() const noexcept {
+    return publish_interval_;
+  }
+
+  // 未发布元素滞留多久后由push_deferred/flush_if_stale()发布，0表示只按数量发布
+  template <typename Rep, typename Period>
+  void set_publish_deadline(const std::chrono::duration<Rep, Period>& bound) noexcept {
+    publish_deadline_ticks_ = ChanClock::ns_to_ticks(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(bound).count());
+  }
+
   T *front() noexcept {
     auto tail = tail_.load(std::memory_order_relaxed);
-    if (head_.load(std::memory_order_acquire) == tail) {
-      return nullptr;
+    // 本地缓存的head显示队列为空时，才重新读取共享的head_
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) {
+        return nullptr;
+      }
     }
-    return &buf_[tail];
+    return slot(tail);
   }
 
   void pop() noexcept {
     auto tail = tail_.load(std::memory_order_relaxed);
-    auto next_tail = tail + 1;
-    if (next_tail == Capacity) {
-      next_tail = 0;
+    slot(tail)->~T();
+    tail_.store(next_index(tail), std::memory_order_release);
+    after_consume(tail);
+  }
+
+  // 阻塞出队：队列为空时按WaitPolicy等待
+  void pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+  }
+
+  // 可休眠的阻塞入队：队列满时先自适应自旋，再在futex上休眠等待消费者唤醒。
+  // 入队后只有消费者已宣布在pop_wait中休眠时才发起唤醒系统调用。
+  // 休眠的一方只会被对端的push_wait/pop_wait唤醒，两端需要配对使用
+  template <typename... Args>
+  void push_wait(Args &&...args) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const next_head = next_index(head);
+
+    if (next_head == cached_tail_) {
+      ChanFutex::await(not_full_, producer_spin_, [this, next_head]() {
+        return next_head != (cached_tail_ = tail_.load(std::memory_order_acquire));
+      });
+    }
+
+    new (slot(head)) T(std::forward<Args>(args)...);
+    after_produce(head, next_head);
+    publish_head(next_head);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    not_empty_.notify();
+  }
+
+  // 可休眠的阻塞出队：队列空时先自适应自旋，再在futex上休眠等待生产者唤醒
+  void pop_wait(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      ChanFutex::await(not_empty_, consumer_spin_, [this, &item]() {
+        return (item = front()) != nullptr;
+      });
+    }
+    out = std::move(*item);
+    pop();
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    not_full_.notify();
+  }
+
+  // 限时入队：队列满时按WaitPolicy等待，超过截止时间仍满则返回false
+  // 等待期间只读取TSC判断是否超时
+  template <typename Clock, typename Duration, typename... Args>
+  bool push_until(const std::chrono::time_point<Clock, Duration> &deadline,
+                  Args &&...args) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    auto const next_head = next_index(head);
+
+    if (next_head == cached_tail_) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (next_head == (cached_tail_ = tail_.load(std::memory_order_acquire))) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+
+    new (slot(head)) T(std::forward<Args>(args)...);
+    after_produce(head, next_head);
+    publish_head(next_head);
+    return true;
+  }
+
+  template <typename Rep, typename Period, typename... Args>
+  bool push_for(const std::chrono::duration<Rep, Period> &timeout, Args &&...args) noexcept {
+    return push_until(ChanClock::deadline_after(timeout), std::forward<Args>(args)...);
+  }
+
+  // 限时出队：队列空时按WaitPolicy等待，超过截止时间仍空则返回false
+  template <typename Clock, typename Duration>
+  bool pop_until(T &out, const std::chrono::time_point<Clock, Duration> &deadline) noexcept {
+    T *item = front();
+    if (!item) {
+      ChanClock::Deadline timer(deadline);
+      WaitPolicy waiter;
+      while (!(item = front())) {
+        if (timer.expired()) {
+          return false;
+        }
+        waiter.wait();
+      }
+    }
+    out = std::move(*item);
+    pop();
+    return true;
+  }
+
+  template <typename Rep, typename Period>
+  bool pop_for(T &out, const std::chrono::duration<Rep, Period> &timeout) noexcept {
+    return pop_until(out, ChanClock::deadline_after(timeout));
+  }
+
+  // 非阻塞出队：队列为空时返回false
+  bool try_pop(T &out) noexcept {
+    T *item = front();
+    if (!item) {
+      return false;
+    }
+    out = std::move(*item);
+    pop();
+    return true;
+  }
+
+  // 延迟释放出队：取出元素后只推进消费者私有的tail，暂不发布tail_，
+  // 累计release_interval()次、或观察到生产者眼中的空位不超过一个间隔时才一次性发布，
+  // 减少生产者缓存行被失效的次数。队列为空时先发布再返回false/等待，
+  // 避免生产者因看不到已释放的空位而一直等待。
+  // 按行分组的SlotLayout下，读完一个缓存行的槽位时也会发布。
+  // 改用其他pop/front接口之前必须调用flush_tail()
+  bool try_pop_deferred(T &out) noexcept {
+    auto const tail = pending_pops_ ? unreleased_tail_ : tail_.load(std::memory_order_relaxed);
+    if (tail == cached_head_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail == cached_head_) {
+        flush_tail();
+        return false;
+      }
+    }
+
+    out = std::move(*slot(tail));
+    slot(tail)->~T();
+    unreleased_tail_ = next_index(tail);
+    after_consume(tail);
+    if (++pending_pops_ >= release_interval_ || completes_line(unreleased_tail_) ||
+        free_slots(cached_head_, tail_.load(std::memory_order_relaxed)) <= release_interval_) {
+      flush_tail();
+    }
+    return true;
+  }
+
+  // 阻塞版本：队列为空时(已发布tail_之后)按WaitPolicy等待
+  void pop_deferred(T &out) noexcept {
+    if (!try_pop_deferred(out)) {
+      WaitPolicy waiter;
+      while (!try_pop_deferred(out)) {
+        waiter.wait();
+      }
     }
-    buf_[tail].~T();
-    tail_.store(next_tail, std::memory_order_release);
+  }
+
+  // 立即发布pop_deferred已取出但尚未释放的槽位
+  void flush_tail() noexcept {
+    if (pending_pops_) {
+      pending_pops_ = 0;
+      tail_.store(unreleased_tail_, std::memory_order_release);
+    }
+  }
+
+  // 每n次pop_deferred发布一次tail_，n为1时与pop相同
+  void set_release_interval(uint32_t n) noexcept {
+    release_interval_ = n ? n : 1;
+  }
+
+  uint32_t release_interval() const noexcept {
+    return release_interval_;
+  }
+
+  // 已取出但尚未发布给生产者的槽位数
+  uint32_t pending_pops() const noexcept {
+    return pending_pops_;
+  }
+
+  // 批量入队：最多写入n个元素，返回实际写入的个数
+  // 整批最多一次acquire(缓存的tail不够用时)和一次release
+  size_t push_n(const T *items, size_t n) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (free_slots(head, cached_tail_) < n) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    n = std::min(n, free_slots(head, cached_tail_));
+    if (n == 0) {
+      return 0;
+    }
+
+    if constexpr (SlotLayout::kContiguous) {
+      ChanUtil::copy_into_ring(slots_.data(), Capacity, head, items, n);
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        new (slot(advance_index(head, i))) T(items[i]);
+      }
+    }
+    publish_head(advance_index(head, n));
+    return n;
+  }
+
+  // 批量出队：最多取出max个元素到out，返回实际取出的个数
+  size_t pop_n(T *out, size_t max) noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (used_slots(cached_head_, tail) < max) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    size_t const n = std::min(max, used_slots(cached_head_, tail));
+    if (n == 0) {
+      return 0;
+    }
+
+    if constexpr (SlotLayout::kContiguous) {
+      ChanUtil::move_from_ring(slots_.data(), Capacity, tail, out, n);
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        T* item = slot(advance_index(tail, i));
+        out[i] = std::move(*item);
+        item->~T();
+      }
+    }
+    tail_.store(advance_index(tail, n), std::memory_order_release);
+    return n;
+  }
+
+  // 零拷贝写入：返回最多n个可写槽位(回绕点处拆成两段)
+  // 槽位中没有构造好的对象，调用方需用placement new直接在队列内存中构造，
+  // 之后调用commit(k)发布前k个槽位。返回的槽位数可能少于n(队列空间不足)
+  ChanUtil::RingSpans<T> reserve(size_t n) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (free_slots(head, cached_tail_) < n) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    n = std::min(n, free_slots(head, cached_tail_));
+    static_assert(SlotLayout::kContiguous, "reserve requires a contiguous slot layout");
+    return ChanUtil::make_spans(slots_.data(), Capacity, head, n);
+  }
+
+  // 发布reserve返回的前k个槽位(k不能超过reserve返回的槽位数)
+  // 只做一次release store，这k个元素对消费者同时可见
+  void commit(size_t k) noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    publish_head(advance_index(head, k));
+  }
+
+  // 零拷贝读取：返回当前所有可读元素(回绕点处拆成两段)
+  // 只做一次acquire，消费者可以直接在队列内存上批量处理，之后调用release(k)
+  ChanUtil::RingSpans<T> read_spans() noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    cached_head_ = head_.load(std::memory_order_acquire);
+    static_assert(SlotLayout::kContiguous, "read_spans requires a contiguous slot layout");
+    return ChanUtil::make_spans(slots_.data(), Capacity, tail,
+                                used_slots(cached_head_, tail));
+  }
+
+  // 消费read_spans返回的前k个元素：析构后只做一次release store
+  void release(size_t k) noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    static_assert(SlotLayout::kContiguous, "release requires a contiguous slot layout");
+    ChanUtil::destroy_in_ring(slots_.data(), Capacity, tail, k);
+    tail_.store(advance_index(tail, k), std::memory_order_release);
+  }
+
+  // 开启eventfd通知模式，返回可以加入epoll的fd，失败返回-1
+  // 必须在生产者/消费者线程开始使用队列之前调用；fd由destroy关闭
+  int enable_eventfd() noexcept {
+#ifdef __linux__
+    if (notify_fd_ < 0) {
+      notify_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+#endif
+    return notify_fd_;
+  }
+
+  int event_fd() const noexcept {
+    return notify_fd_;
+  }
+
+  // 消费者准备在epoll上等待前调用：设置"通知已就绪"标志后再检查一次队列。
+  // 返回true表示队列仍为空，可以安全地等待fd可读；
+  // 返回false表示已有数据，应直接处理而不是等待。
+  // 生产者只在标志被设置时(即空->非空)写一次eventfd，高负载下没有多余的系统调用
+  bool arm_notification() noexcept {
+    notify_armed_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (front() == nullptr) {
+      return true;
+    }
+    notify_armed_.store(false, std::memory_order_relaxed);
+    return false;
+  }
+
+  // fd可读后由消费者调用，清空eventfd计数
+  void consume_notification() noexcept {
+#ifdef __linux__
+    uint64_t count;
+    while (read(notify_fd_, &count, sizeof(count)) == sizeof(count)) {
+    }
+#endif
   }
 
   size_t size() const noexcept {
@@ -96,12 +557,96 @@ class SPSCQueueSoftArray {
     return Capacity;
   }
 
+  // 队列内存实际使用的页面类型，create()分配的队列为普通页
+  ChanAlloc::PageSize page_size() const noexcept {
+    return allocation_.page_size;
+  }
+
+  // create(options)的NUMA放置是否生效(单节点机器上始终为false)
+  bool numa_bound() const noexcept {
+    return allocation_.numa_bound;
+  }
+
+  // create(options)是否预先缺页、mlock是否成功
+  bool prefaulted() const noexcept {
+    return allocation_.prefaulted;
+  }
+
+  bool locked() const noexcept {
+    return allocation_.locked;
+  }
+
+  // 各索引字段和第一个槽位相对队列起始地址的偏移，用于检查IndexLayout的实际效果
+  struct IndexOffsets {
+    size_t head;
+    size_t cached_tail;
+    size_t tail;
+    size_t cached_head;
+    size_t first_slot;
+  };
+
+  IndexOffsets index_offsets() noexcept {
+    auto const offset = [this](const void* field) {
+      return static_cast<size_t>(reinterpret_cast<const char*>(field) -
+                                 reinterpret_cast<const char*>(this));
+    };
+    return {offset(&head_), offset(&cached_tail_), offset(&tail_), offset(&cached_head_),
+            offset(slot(0))};
+  }
+
+  // 生产者线程在发送第一条消息前调用一次：把自己的索引行写入本核缓存、
+  // 读取一次对端的tail_，并预取接下来要写的几个缓存行的槽位，
+  // 第一条消息就不用再承担这些缓存未命中
+  void warm_producer() noexcept {
+    auto const head = head_.load(std::memory_order_relaxed);
+    head_.store(head, std::memory_order_relaxed);
+    cached_tail_ = tail_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < kWarmSlots; ++i) {
+      __builtin_prefetch(slot(advance_index(head, i)), 1);
+    }
+  }
+
+  // 消费者线程在读取第一条消息前调用一次，作用同warm_producer
+  void warm_consumer() noexcept {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(tail, std::memory_order_relaxed);
+    cached_head_ = head_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < kWarmSlots; ++i) {
+      __builtin_prefetch(slot(advance_index(tail, i)), 0);
+    }
+  }
+
  private:
+  // 索引块的对齐；kCached为0时本地副本按int的自然对齐紧跟在索引之后
+  using IndexAlign = typename IndexLayout::template Align<kCacheLineSize>;
+  static constexpr size_t kIndexAlign = IndexAlign::kIndex;
+  static constexpr size_t kCachedAlign = IndexAlign::kCached ? IndexAlign::kCached : alignof(int);
+
+  using Storage = typename SlotLayout::template Storage<T, Capacity, kCacheLineSize>;
+  static constexpr size_t kSlotsPerLine = Storage::kSlotsPerLine;
+  // 按行发布时push_deferred/pop_deferred的默认间隔为每行元素数，否则为1
+  static constexpr uint32_t kLineInterval =
+      SlotLayout::kPublishPerLine ? static_cast<uint32_t>(kSlotsPerLine) : 1;
+
+  // 预取和降级按缓存行进行：每行的槽位数，以及两端向前预取的槽位距离(不超过一圈)
+  static constexpr size_t kSlotsPerPrefetchLine =
+      kSlotsPerLine ? kSlotsPerLine : std::max<size_t>(1, kCacheLineSize / sizeof(T));
+  static constexpr size_t kProducerAhead =
+      std::min<size_t>(Capacity - 1, size_t(PrefetchPolicy::kProducerLines) * kSlotsPerPrefetchLine);
+  static constexpr size_t kConsumerAhead =
+      std::min<size_t>(Capacity - 1, size_t(PrefetchPolicy::kConsumerLines) * kSlotsPerPrefetchLine);
+
+  // warm_producer/warm_consumer预取的槽位数：覆盖8个缓存行
+  static constexpr size_t kWarmSlots = std::min<size_t>(
+      Capacity, kSlotsPerLine ? 8 * kSlotsPerLine : (8 * kCacheLineSize + sizeof(T) - 1) / sizeof(T));
+
   // 私有构造函数，只能通过create方法创建
-  SPSCQueueSoftArray() noexcept = default;
+  // 槽位中的元素不在这里构造，由push通过placement new构造
+  SPSCQueueSoftArray() noexcept {}
   
   // 私有析构函数，只能通过destroy方法销毁
-  ~SPSCQueueSoftArray() = default;
+  // 剩余元素已在destroy中pop析构，这里不能再次析构槽位
+  ~SPSCQueueSoftArray() {}
 
   // 禁止拷贝和移动
   SPSCQueueSoftArray(const SPSCQueueSoftArray&) = delete;
@@ -109,9 +654,133 @@ class SPSCQueueSoftArray {
   SPSCQueueSoftArray(SPSCQueueSoftArray&&) = delete;
   SPSCQueueSoftArray& operator=(SPSCQueueSoftArray&&) = delete;
 
-  alignas(kCacheLineSize) std::atomic<int> head_{0};
-  alignas(kCacheLineSize) std::atomic<int> tail_{0};
-  alignas(kCacheLineSize) T buf_[Capacity];
+  // 发布head_；eventfd模式下，消费者已就绪等待时写一次eventfd
+  void publish_head(int next_head) noexcept {
+    head_.store(next_head, std::memory_order_release);
+    if (notify_fd_ >= 0) {
+      signal_consumer();
+    }
+  }
+
+  void signal_consumer() noexcept {
+    // 与arm_notification中的fence配对：要么消费者能看到新的head_，
+    // 要么这里能看到notify_armed_
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (notify_armed_.load(std::memory_order_relaxed) &&
+        notify_armed_.exchange(false, std::memory_order_acq_rel)) {
+#ifdef __linux__
+      uint64_t one = 1;
+      ssize_t written = write(notify_fd_, &one, sizeof(one));
+      (void)written;
+#endif
+    }
+  }
+
+  T* slot(int index) noexcept {
+    return slots_.slot(static_cast<size_t>(index));
+  }
+
+  // 按行发布时，index是否恰好位于一个缓存行的槽位组的开头(即上一行已写满/读完)
+  static bool completes_line(int index) noexcept {
+    if constexpr (SlotLayout::kPublishPerLine) {
+      return index % static_cast<int>(kSlotsPerLine) == 0;
+    } else {
+      (void)index;
+      return false;
+    }
+  }
+
+  // 生产者写完head槽位后调用：进入新的一行时对前方第kProducerAhead个槽位发出写意图预取，
+  // 写满一行时按策略降级这一行
+  void after_produce(int head, int next_head) noexcept {
+    if constexpr (PrefetchPolicy::kProducerLines > 0) {
+      if (head % static_cast<int>(kSlotsPerPrefetchLine) == 0) {
+        ChanPrefetch::write_intent(slot(advance_index(head, kProducerAhead)));
+      }
+    }
+    if constexpr (PrefetchPolicy::kDemote) {
+      if (next_head % static_cast<int>(kSlotsPerPrefetchLine) == 0) {
+        ChanPrefetch::demote(slot(head));
+      }
+    }
+    (void)head;
+    (void)next_head;
+  }
+
+  // 消费者读完tail槽位后调用：进入新的一行时对前方第kConsumerAhead个槽位发出读预取
+  void after_consume(int tail) noexcept {
+    if constexpr (PrefetchPolicy::kConsumerLines > 0) {
+      if (tail % static_cast<int>(kSlotsPerPrefetchLine) == 0) {
+        ChanPrefetch::read(slot(advance_index(tail, kConsumerAhead)));
+      }
+    }
+    (void)tail;
+  }
+
+  static int next_index(int index) noexcept {
+    ++index;
+    if (index == static_cast<int>(Capacity)) {
+      index = 0;
+    }
+    return index;
+  }
+
+  static int advance_index(int index, size_t n) noexcept {
+    index += static_cast<int>(n);
+    if (index >= static_cast<int>(Capacity)) {
+      index -= static_cast<int>(Capacity);
+    }
+    return index;
+  }
+
+  // [tail, head)中已有元素个数
+  static size_t used_slots(int head, int tail) noexcept {
+    int diff = head - tail;
+    if (diff < 0) {
+      diff += Capacity;
+    }
+    return static_cast<size_t>(diff);
+  }
+
+  // 可写入的空位个数(保留一个空位区分满和空)
+  static size_t free_slots(int head, int tail) noexcept {
+    return Capacity - 1 - used_slots(head, tail);
+  }
+
+  // 生产者写head_，并按IndexLayout在独立的缓存行或同一行上保存tail_的本地副本
+  alignas(kIndexAlign) std::atomic<int> head_{0};
+  alignas(kCachedAlign) int cached_tail_ = 0;
+  AdaptiveSpin producer_spin_;
+  int notify_fd_ = -1;  // eventfd模式下的fd，-1表示未开启
+  // push_deferred的状态：尚未发布的head和个数，以及发布间隔和滞留时长上限(tick)
+  int unpublished_head_ = 0;
+  uint32_t pending_count_ = 0;
+  uint32_t publish_interval_ = kLineInterval;
+  uint64_t publish_deadline_ticks_ = 0;
+  uint64_t first_pending_ticks_ = 0;
+
+  // 消费者写tail_，并按IndexLayout在独立的缓存行或同一行上保存head_的本地副本
+  alignas(kIndexAlign) std::atomic<int> tail_{0};
+  alignas(kCachedAlign) int cached_head_ = 0;
+  AdaptiveSpin consumer_spin_;
+  // pop_deferred的状态：尚未发布的tail和个数，以及发布间隔
+  int unreleased_tail_ = 0;
+  uint32_t pending_pops_ = 0;
+  uint32_t release_interval_ = kLineInterval;
+
+  // push_wait/pop_wait的休眠唤醒：消费者在not_empty_上休眠，生产者在not_full_上休眠
+  alignas(kIndexAlign) EventCount not_empty_;
+  alignas(kCacheLineSize) EventCount not_full_;
+
+  // eventfd模式：消费者准备等待时置位，生产者写eventfd时清除
+  alignas(kCacheLineSize) std::atomic<bool> notify_armed_{false};
+
+  // create(options)的分配记录，只在destroy时读取；create()分配时base为空
+  ChanAlloc::Allocation allocation_;
+
+  // 槽位存储，布局由SlotLayout决定，见chan_layout.h；
+  // 各布局都不会在构造/析构队列时对槽位调用T的构造/析构函数
+  Storage slots_;
 };
 
 #endif  // _PERF_TEST_CHAN_SOFT_ARRAY_H_
\ No newline at end of file
@@ -0,0 +1,158 @@
+#ifndef _PERF_TEST_CHAN_STATS_H_
+#define _PERF_TEST_CHAN_STATS_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+#include <pthread.h>
+#include <sched.h>
+#include "chan_clock.h"
+
+// 基准测试用的统计工具，以及各基准测试共用的线程绑定和等待辅助函数
+namespace ChanStats {
+    // HDR风格的对数-线性直方图：每个2的幂区间再线性分成kSubBuckets / 2个桶，
+    // 任何值的相对误差都不超过 2 / kSubBuckets (kSubBits为7时小于1.6%)。
+    // 记录只是一次下标计算和一次自增，可以在测量循环里逐条调用；
+    // 值的单位由调用方决定，基准测试中记录的是TSC tick，报告时再换算成纳秒
+    class LatencyHistogram {
+     public:
+        static constexpr uint32_t kSubBits = 7;
+        static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBits;
+        static constexpr uint64_t kHalfBuckets = kSubBuckets / 2;
+        // 64位值的最高位为63，对应的最大下标为 (63 - kSubBits + 1) * kHalfBuckets + kSubBuckets - 1
+        static constexpr size_t kBucketCount = (64 - kSubBits + 1) * kHalfBuckets + kHalfBuckets;
+
+        LatencyHistogram() noexcept {
+            reset();
+        }
+
+        void reset() noexcept {
+            std::memset(counts_, 0, sizeof(counts_));
+            count_ = 0;
+            sum_ = 0;
+            min_ = UINT64_MAX;
+            max_ = 0;
+        }
+
+        void record(uint64_t value) noexcept {
+            ++counts_[bucket_of(value)];
+            ++count_;
+            sum_ += value;
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+
+        // 合并另一个直方图(例如多轮测试或多个线程各自记录的结果)
+        void merge(const LatencyHistogram& other) noexcept {
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                counts_[i] += other.counts_[i];
+            }
+            count_ += other.count_;
+            sum_ += other.sum_;
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+
+        uint64_t count() const noexcept { return count_; }
+        uint64_t min() const noexcept { return count_ ? min_ : 0; }
+        uint64_t max() const noexcept { return max_; }
+
+        double mean() const noexcept {
+            return count_ ? static_cast<double>(sum_) / count_ : 0.0;
+        }
+
+        // 第percentile百分位(0~100)的值：返回该桶能代表的最大值，不会低估尾延迟；
+        // 100返回记录到的精确最大值
+        uint64_t percentile(double percentile) const noexcept {
+            if (count_ == 0) {
+                return 0;
+            }
+            if (percentile >= 100.0) {
+                return max_;
+            }
+            uint64_t target = static_cast<uint64_t>(percentile / 100.0 * count_ + 0.5);
+            target = std::max<uint64_t>(1, std::min(target, count_));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                seen += counts_[i];
+                if (seen >= target) {
+                    return std::min(highest_equivalent(i), max_);
+                }
+            }
+            return max_;
+        }
+
+        // 按纳秒报告：记录的值为TSC tick时使用
+        double percentile_ns(double percentile) const noexcept {
+            return ChanClock::ticks_to_ns(this->percentile(percentile));
+        }
+
+     private:
+        static size_t bucket_of(uint64_t value) noexcept {
+            if (value < kSubBuckets) {
+                return static_cast<size_t>(value);
+            }
+            // 把最高位移到第kSubBits - 1位，余下的高位就是区间内的线性桶号
+            uint32_t const shift = 63 - __builtin_clzll(value) - (kSubBits - 1);
+            return static_cast<size_t>(shift * kHalfBuckets + (value >> shift));
+        }
+
+        static uint64_t highest_equivalent(size_t bucket) noexcept {
+            if (bucket < kSubBuckets) {
+                return bucket;
+            }
+            uint64_t const shift = bucket / kHalfBuckets - 1;
+            uint64_t const sub = bucket - shift * kHalfBuckets;
+            return ((sub + 1) << shift) - 1;
+        }
+
+        uint64_t counts_[kBucketCount];
+        uint64_t count_;
+        uint64_t sum_;
+        uint64_t min_;
+        uint64_t max_;
+    };
+
+    // 只有一个CPU时两端无法同时运行，等待中主动让出CPU，否则每次都要等到时间片用完；
+    // 由基准测试的main()在hardware_concurrency() < 2时打开
+    inline bool yield_when_idle = false;
+
+    static inline void idle() noexcept {
+        if (yield_when_idle) {
+            std::this_thread::yield();
+        }
+    }
+
+    // 把调用线程绑定到cpu，cpu为负数时不绑定；返回是否成功
+    // (cpu不存在或不在进程允许的集合内时失败，线程仍按原来的亲和性运行)
+    static inline bool pin_to_cpu(int cpu) noexcept {
+        if (cpu < 0) {
+            return true;
+        }
+        if (cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    // 等到队列非空后取出一个元素，等待中按idle()让出CPU
+    template <typename Queue>
+    static inline auto receive(Queue* queue) noexcept
+        -> std::remove_reference_t<decltype(*queue->front())> {
+        decltype(queue->front()) item;
+        while (!(item = queue->front())) {
+            idle();
+        }
+        auto const value = *item;
+        queue->pop();
+        return value;
+    }
+}
+
+#endif  // _PERF_TEST_CHAN_STATS_H_
@@ -0,0 +1,112 @@
+#ifndef _PERF_TEST_CHAN_UTIL_H_
+#define _PERF_TEST_CHAN_UTIL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 各队列实现共用的环形缓冲区辅助函数
+namespace ChanUtil {
+    // 环形缓冲区中的一段连续槽位
+    template <typename T>
+    struct RingSpan {
+        T* data = nullptr;
+        size_t size = 0;
+
+        T* begin() const noexcept { return data; }
+        T* end() const noexcept { return data + size; }
+    };
+
+    // 环形缓冲区中的一组槽位，在回绕点处最多拆成两段
+    template <typename T>
+    struct RingSpans {
+        RingSpan<T> first;
+        RingSpan<T> second;
+
+        size_t size() const noexcept { return first.size + second.size; }
+        bool empty() const noexcept { return size() == 0; }
+
+        // 按逻辑顺序访问第i个槽位
+        T& operator[](size_t i) const noexcept {
+            return i < first.size ? first.data[i] : second.data[i - first.size];
+        }
+    };
+
+    // 构造覆盖ring中[index, index + n)的槽位段
+    template <typename T>
+    static inline RingSpans<T> make_spans(T* ring, size_t capacity, size_t index,
+                                          size_t n) noexcept {
+        RingSpans<T> spans;
+        const size_t first = std::min(n, capacity - index);
+        spans.first = {ring + index, first};
+        if (n > first) {
+            spans.second = {ring, n - first};
+        }
+        return spans;
+    }
+
+    // 析构环形缓冲区ring中[index, index + n)的元素，平凡析构类型什么都不做
+    template <typename T>
+    static inline void destroy_in_ring(T* ring, size_t capacity, size_t index,
+                                       size_t n) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            const size_t first = std::min(n, capacity - index);
+            for (size_t i = 0; i < first; ++i) {
+                ring[index + i].~T();
+            }
+            for (size_t i = 0; i < n - first; ++i) {
+                ring[i].~T();
+            }
+        }
+    }
+
+    // 将src中的n个元素拷贝到环形缓冲区ring的[index, index + n)位置
+    // 跨越回绕点时拆成两段；平凡可拷贝类型最多两次memcpy
+    template <typename T>
+    static inline void copy_into_ring(T* ring, size_t capacity, size_t index,
+                                      const T* src, size_t n) noexcept {
+        const size_t first = std::min(n, capacity - index);
+        const size_t second = n - first;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(ring + index), src, first * sizeof(T));
+            if (second) {
+                std::memcpy(static_cast<void*>(ring), src + first, second * sizeof(T));
+            }
+        } else {
+            for (size_t i = 0; i < first; ++i) {
+                new (&ring[index + i]) T(src[i]);
+            }
+            for (size_t i = 0; i < second; ++i) {
+                new (&ring[i]) T(src[first + i]);
+            }
+        }
+    }
+
+    // 将环形缓冲区ring中[index, index + n)的元素移动到dst，并析构原元素
+    template <typename T>
+    static inline void move_from_ring(T* ring, size_t capacity, size_t index,
+                                      T* dst, size_t n) noexcept {
+        const size_t first = std::min(n, capacity - index);
+        const size_t second = n - first;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(static_cast<void*>(dst), ring + index, first * sizeof(T));
+            if (second) {
+                std::memcpy(static_cast<void*>(dst + first), ring, second * sizeof(T));
+            }
+        } else {
+            for (size_t i = 0; i < first; ++i) {
+                dst[i] = std::move(ring[index + i]);
+                ring[index + i].~T();
+            }
+            for (size_t i = 0; i < second; ++i) {
+                dst[first + i] = std::move(ring[i]);
+                ring[i].~T();
+            }
+        }
+    }
+}
+
+#endif  // _PERF_TEST_CHAN_UTIL_H_
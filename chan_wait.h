@@ -0,0 +1,80 @@
+#ifndef _PERF_TEST_CHAN_WAIT_H_
+#define _PERF_TEST_CHAN_WAIT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// 队列满/空时的等待策略
+//
+// 每次阻塞操作在慢路径上构造一个策略对象，循环调用wait()直到条件满足，
+// 因此有状态的策略(退避次数等)只在单次等待内累积。
+namespace ChanWait {
+    // 自旋等待提示：降低自旋对同核超线程和功耗的影响
+    static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield" ::: "memory");
+#else
+        __asm__ __volatile__("" ::: "memory");
+#endif
+    }
+}
+
+// 纯自旋：空循环，延迟最低，始终占满一个核
+struct SpinWait {
+    static const char* name() { return "spin"; }
+    void wait() noexcept {}
+};
+
+// 自旋 + pause(x86) / yield(ARM) 指令
+struct PauseWait {
+    static const char* name() { return "pause"; }
+    void wait() noexcept { ChanWait::cpu_relax(); }
+};
+
+// 指数退避：每次等待的pause次数翻倍，直到kMaxSpins
+template <uint32_t kMaxSpins = 1024>
+struct BackoffWait {
+    static const char* name() { return "backoff"; }
+    void wait() noexcept {
+        for (uint32_t i = 0; i < spins_; ++i) {
+            ChanWait::cpu_relax();
+        }
+        if (spins_ < kMaxSpins) {
+            spins_ <<= 1;
+        }
+    }
+
+ private:
+    uint32_t spins_ = 1;
+};
+
+// 每次等待都让出CPU (Linux上即sched_yield)
+struct YieldWait {
+    static const char* name() { return "yield"; }
+    void wait() noexcept { std::this_thread::yield(); }
+};
+
+// 先有限次数自旋，超过kSpinCount次后每次睡眠kSleepMicros微秒
+template <uint32_t kSpinCount = 4096, uint32_t kSleepMicros = 50>
+struct SpinThenSleepWait {
+    static const char* name() { return "spin-then-sleep"; }
+    void wait() noexcept {
+        if (spins_ < kSpinCount) {
+            ++spins_;
+            ChanWait::cpu_relax();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(kSleepMicros));
+        }
+    }
+
+ private:
+    uint32_t spins_ = 0;
+};
+
+#endif  // _PERF_TEST_CHAN_WAIT_H_
@@ -0,0 +1,438 @@
+#include <atomic>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <dirent.h>
+#include <sched.h>
+#include "chan_soft_array.h"
+#include "chan_clock.h"
+#include "chan_stats.h"
+
+// 测试参数
+constexpr int ROUND_TRIP_COUNT = 20000;  // 每对CPU的往返次数
+constexpr int WARMUP_COUNT = 1000;       // 往返测试前丢弃的次数
+constexpr int STREAM_COUNT = 500000;     // 每对CPU的吞吐量测试消息数
+constexpr size_t MAX_CPUS = 64;          // 最多测试的CPU数，配对数随CPU数平方增长
+
+using Queue = SPSCQueueSoftArray<uint64_t, 1024>;
+
+// 两个CPU之间的拓扑关系，由近到远
+enum Relation {
+    SMT_SIBLING,      // 同一物理核的两个硬件线程，共享L1/L2
+    SHARED_L3,        // 不同物理核，共享L3(同一CCX/同一die)
+    SAME_PACKAGE,     // 同一插槽，不共享L3
+    CROSS_PACKAGE,    // 跨插槽
+    RELATION_COUNT
+};
+
+static const char* relation_name(int relation) {
+    static const char* const kNames[RELATION_COUNT] = {"SMT兄弟", "同L3", "同插槽不同L3", "跨插槽"};
+    return kNames[relation];
+}
+
+struct CpuTopology {
+    int cpu;
+    int package;
+    int core;
+    int node;
+    std::string smt_group;   // 同一物理核的CPU列表
+    std::string l3_group;    // 共享L3的CPU列表，读不到时为空
+};
+
+static std::string read_line(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+static int read_int(const std::string& path, int fallback) {
+    std::string const line = read_line(path);
+    return line.empty() ? fallback : std::stoi(line);
+}
+
+static CpuTopology read_topology(int cpu) {
+    std::string const base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    CpuTopology topology{cpu, 0, cpu, 0, "", ""};
+    topology.package = read_int(base + "/topology/physical_package_id", 0);
+    topology.core = read_int(base + "/topology/core_id", cpu);
+    // core_cpus_list是较新内核的名字，老内核只有thread_siblings_list
+    topology.smt_group = read_line(base + "/topology/core_cpus_list");
+    if (topology.smt_group.empty()) {
+        topology.smt_group = read_line(base + "/topology/thread_siblings_list");
+    }
+    for (int index = 0; index < 8; ++index) {
+        std::string const cache = base + "/cache/index" + std::to_string(index);
+        if (read_int(cache + "/level", 0) == 3) {
+            topology.l3_group = read_line(cache + "/shared_cpu_list");
+            break;
+        }
+    }
+    // 所在NUMA节点表现为cpuN目录下的nodeM链接
+    if (DIR* dir = opendir(base.c_str())) {
+        while (dirent* entry = readdir(dir)) {
+            std::string const name = entry->d_name;
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                topology.node = std::stoi(name.substr(4));
+            }
+        }
+        closedir(dir);
+    }
+    return topology;
+}
+
+static Relation classify(const CpuTopology& a, const CpuTopology& b) {
+    if (!a.smt_group.empty() && a.smt_group == b.smt_group) {
+        return SMT_SIBLING;
+    }
+    if (!a.l3_group.empty() && a.l3_group == b.l3_group) {
+        return SHARED_L3;
+    }
+    return a.package == b.package ? SAME_PACKAGE : CROSS_PACKAGE;
+}
+
+// 当前进程允许运行的CPU
+static std::vector<int> allowed_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+}
+
+// 两个线程都绑定好之后才同时开始，线程创建和迁移不计入结果
+class StartGate {
+public:
+    void arrive_and_wait() {
+        arrived_.fetch_add(1, std::memory_order_acq_rel);
+        while (arrived_.load(std::memory_order_acquire) < 2) {
+        }
+    }
+
+private:
+    std::atomic<int> arrived_{0};
+};
+
+struct PairResult {
+    double one_way_ns;     // 往返延迟中位数的一半
+    double throughput;     // msgs/sec，a生产，b消费
+    bool pinned;           // 两项测试的两个线程都绑定成功；失败的CPU对不计入汇总和建议
+};
+
+static Queue* create_queue() {
+    Queue* queue = Queue::create();
+    if (!queue) {
+        std::cerr << "队列创建失败" << std::endl;
+        exit(1);
+    }
+    return queue;
+}
+
+// 往返延迟：a经ping发送，b从ping取出后经pong发回；pinned返回两端是否都绑定成功
+static double round_trip_median_ns(int a, int b, bool* pinned) {
+    Queue* ping = create_queue();
+    Queue* pong = create_queue();
+    ChanStats::LatencyHistogram* histogram = new ChanStats::LatencyHistogram();
+    StartGate gate;
+    bool pinned_a = false;
+    bool pinned_b = false;
+
+    std::thread responder([ping, pong, b, &gate, &pinned_b]() {
+        pinned_b = ChanStats::pin_to_cpu(b);
+        gate.arrive_and_wait();
+        uint64_t value;
+        for (int i = 0; i < WARMUP_COUNT + ROUND_TRIP_COUNT; ++i) {
+            ping->pop(value);
+            pong->push(value);
+        }
+    });
+
+    std::thread initiator([ping, pong, a, histogram, &gate, &pinned_a]() {
+        pinned_a = ChanStats::pin_to_cpu(a);
+        gate.arrive_and_wait();
+        uint64_t value;
+        for (int i = 0; i < WARMUP_COUNT + ROUND_TRIP_COUNT; ++i) {
+            uint64_t const start = ChanClock::ticks();
+            ping->push(static_cast<uint64_t>(i));
+            pong->pop(value);
+            if (i >= WARMUP_COUNT) {
+                histogram->record(ChanClock::ticks() - start);
+            }
+        }
+    });
+
+    initiator.join();
+    responder.join();
+    *pinned = pinned_a && pinned_b;
+    double const median_ns = histogram->percentile_ns(50);
+    delete histogram;
+    Queue::destroy(ping);
+    Queue::destroy(pong);
+    return median_ns / 2;
+}
+
+static double stream_throughput(int producer_cpu, int consumer_cpu, bool* pinned) {
+    Queue* queue = create_queue();
+    StartGate gate;
+    uint64_t start = 0;
+    bool pinned_producer = false;
+    bool pinned_consumer = false;
+
+    std::thread producer([queue, producer_cpu, &gate, &start, &pinned_producer]() {
+        pinned_producer = ChanStats::pin_to_cpu(producer_cpu);
+        gate.arrive_and_wait();
+        start = ChanClock::ticks();
+        for (int i = 0; i < STREAM_COUNT; ++i) {
+            queue->push(static_cast<uint64_t>(i));
+        }
+    });
+
+    std::thread consumer([queue, consumer_cpu, &gate, &pinned_consumer]() {
+        pinned_consumer = ChanStats::pin_to_cpu(consumer_cpu);
+        gate.arrive_and_wait();
+        uint64_t value;
+        for (int i = 0; i < STREAM_COUNT; ++i) {
+            queue->pop(value);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    *pinned = pinned_producer && pinned_consumer;
+    double const elapsed_ns = ChanClock::ticks_to_ns(ChanClock::ticks() - start);
+    Queue::destroy(queue);
+    return STREAM_COUNT * 1e9 / elapsed_ns;
+}
+
+static void print_matrix(const char* title, const std::vector<int>& cpus,
+                         const std::vector<std::vector<PairResult>>& results,
+                         double PairResult::*field, double scale, int precision) {
+    std::cout << "\n" << title << std::endl;
+    std::cout << "  P\\C";
+    for (int cpu : cpus) {
+        std::cout << std::setw(7) << cpu;
+    }
+    std::cout << std::endl;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        std::cout << std::setw(5) << cpus[i];
+        for (size_t j = 0; j < cpus.size(); ++j) {
+            if (i == j) {
+                std::cout << std::setw(7) << "-";
+            } else if (!results[i][j].pinned) {
+                std::cout << std::setw(7) << "!";
+            } else {
+                std::cout << std::setw(7) << std::fixed << std::setprecision(precision)
+                          << results[i][j].*field * scale;
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+// 按显示宽度左侧补空格：setw按字节计算，中文字符占3字节、显示2列
+static std::string pad_left(const std::string& text, size_t width) {
+    size_t columns = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) {
+            columns += c >= 0xE0 ? 2 : 1;
+        }
+    }
+    return std::string(width > columns ? width - columns : 0, ' ') + text;
+}
+
+struct RelationSummary {
+    int pairs = 0;
+    double latency_sum = 0;
+    double throughput_sum = 0;
+    double best_latency = 0;
+    int best_a = -1;
+    int best_b = -1;
+
+    double mean_latency() const { return latency_sum / pairs; }
+    double mean_throughput() const { return throughput_sum / pairs; }
+};
+
+static void recommend(const std::vector<int>& cpus, const std::vector<CpuTopology>& topology,
+                      const std::vector<std::vector<PairResult>>& results) {
+    RelationSummary summary[RELATION_COUNT];
+    size_t best_latency_i = 0, best_latency_j = 0;
+    size_t best_throughput_i = 0, best_throughput_j = 0;
+    bool found = false;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        for (size_t j = 0; j < cpus.size(); ++j) {
+            if (i == j || !results[i][j].pinned) {
+                continue;
+            }
+            const PairResult& r = results[i][j];
+            if (!found) {
+                best_latency_i = best_throughput_i = i;
+                best_latency_j = best_throughput_j = j;
+                found = true;
+            }
+            RelationSummary& s = summary[classify(topology[i], topology[j])];
+            ++s.pairs;
+            s.latency_sum += r.one_way_ns;
+            s.throughput_sum += r.throughput;
+            if (s.best_a < 0 || r.one_way_ns < s.best_latency) {
+                s.best_latency = r.one_way_ns;
+                s.best_a = cpus[i];
+                s.best_b = cpus[j];
+            }
+            if (r.one_way_ns < results[best_latency_i][best_latency_j].one_way_ns) {
+                best_latency_i = i;
+                best_latency_j = j;
+            }
+            if (r.throughput > results[best_throughput_i][best_throughput_j].throughput) {
+                best_throughput_i = i;
+                best_throughput_j = j;
+            }
+        }
+    }
+
+    if (!found) {
+        std::cout << "\n所有CPU对都绑定失败，结果不反映核间拓扑，不给出汇总和放置建议" << std::endl;
+        return;
+    }
+
+    std::cout << "\n按拓扑关系汇总 (不含绑定失败的CPU对)" << std::endl;
+    std::cout << "         关系 | CPU对数 | 平均单向(ns) | 最低单向(ns) |  最低的CPU对 | 平均吞吐(M msg/s)" << std::endl;
+    std::cout << "--------------|---------|--------------|--------------|--------------|------------------" << std::endl;
+    for (int relation = 0; relation < RELATION_COUNT; ++relation) {
+        const RelationSummary& s = summary[relation];
+        if (s.pairs == 0) {
+            continue;
+        }
+        std::string const pair = std::to_string(s.best_a) + " - " + std::to_string(s.best_b);
+        std::cout << pad_left(relation_name(relation), 13) << " | "
+                  << std::setw(7) << s.pairs << " | "
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(12) << s.mean_latency() << " | "
+                  << std::setw(12) << s.best_latency << " | "
+                  << std::setw(12) << pair << " | "
+                  << std::setprecision(2) << std::setw(16) << s.mean_throughput() / 1e6 << std::endl;
+    }
+
+    std::cout << "\n放置建议:" << std::endl;
+    std::cout << "• 延迟最低: CPU " << cpus[best_latency_i] << " 与 CPU " << cpus[best_latency_j]
+              << "，单向 " << std::setprecision(1) << results[best_latency_i][best_latency_j].one_way_ns << " ns ("
+              << relation_name(classify(topology[best_latency_i], topology[best_latency_j])) << ")" << std::endl;
+    std::cout << "• 吞吐最高: CPU " << cpus[best_throughput_i] << " 生产，CPU " << cpus[best_throughput_j]
+              << " 消费，" << std::setprecision(2) << results[best_throughput_i][best_throughput_j].throughput / 1e6
+              << " M msg/s ("
+              << relation_name(classify(topology[best_throughput_i], topology[best_throughput_j])) << ")" << std::endl;
+
+    const RelationSummary& smt = summary[SMT_SIBLING];
+    const RelationSummary& shared = summary[SHARED_L3];
+    if (smt.pairs > 0 && shared.pairs > 0) {
+        std::cout << "• SMT兄弟平均单向 " << std::setprecision(1) << smt.mean_latency() << " ns，同L3 "
+                  << shared.mean_latency() << " ns；SMT兄弟共用一个物理核的执行单元，"
+                  << "两端除收发外还有较多计算时，优先选同L3的不同物理核 (如 CPU "
+                  << shared.best_a << " 与 CPU " << shared.best_b << ")" << std::endl;
+    }
+    if (shared.pairs > 0) {
+        for (int relation : {SAME_PACKAGE, CROSS_PACKAGE}) {
+            const RelationSummary& far = summary[relation];
+            if (far.pairs == 0) {
+                continue;
+            }
+            double const ratio = far.mean_latency() / shared.mean_latency();
+            std::cout << "• " << relation_name(relation) << "的平均延迟是同L3的 " << std::setprecision(1) << ratio
+                      << " 倍：" << (ratio > 1.2 ? "生产者和消费者应放在同一L3组内" : "与同L3相差不大，放置较自由")
+                      << std::endl;
+        }
+        // 列出各L3组，方便直接拿来设置亲和性
+        std::vector<std::string> groups;
+        for (const CpuTopology& t : topology) {
+            if (!t.l3_group.empty() && std::find(groups.begin(), groups.end(), t.l3_group) == groups.end()) {
+                groups.push_back(t.l3_group);
+            }
+        }
+        std::cout << "• L3组:";
+        for (const std::string& group : groups) {
+            std::cout << " [" << group << "]";
+        }
+        std::cout << std::endl;
+    }
+    if (summary[CROSS_PACKAGE].pairs > 0) {
+        std::cout << "• 必须跨插槽时，把队列内存放在消费者所在的NUMA节点 (见 numa_benchmark)" << std::endl;
+    }
+    int classes = 0;
+    for (const RelationSummary& s : summary) {
+        classes += s.pairs > 0 ? 1 : 0;
+    }
+    if (classes == 1) {
+        std::cout << "• 所有CPU对都属于同一类拓扑关系，放置对延迟影响不大，按上面测得的最低延迟对选择即可" << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "SPSC 队列核间延迟矩阵基准测试" << std::endl;
+    std::cout << "==============================" << std::endl;
+
+    std::vector<int> cpus = allowed_cpus();
+    std::cout << "可用CPU数: " << cpus.size() << std::endl;
+    if (cpus.size() > MAX_CPUS) {
+        std::cout << "只测试前 " << MAX_CPUS << " 个CPU (可用taskset限制进程的CPU集合来选择)" << std::endl;
+        cpus.resize(MAX_CPUS);
+    }
+
+    std::vector<CpuTopology> topology;
+    std::cout << "\n CPU | 插槽 | 节点 | 核心 | SMT组        | L3组" << std::endl;
+    std::cout << "-----|------|------|------|--------------|----------------" << std::endl;
+    for (int cpu : cpus) {
+        topology.push_back(read_topology(cpu));
+        const CpuTopology& t = topology.back();
+        std::cout << std::setw(4) << t.cpu << " | " << std::setw(4) << t.package << " | "
+                  << std::setw(4) << t.node << " | " << std::setw(4) << t.core << " | "
+                  << std::left << std::setw(12) << t.smt_group << " | "
+                  << (t.l3_group.empty() ? "-" : t.l3_group) << std::right << std::endl;
+    }
+
+    if (cpus.size() < 2) {
+        std::cout << "\n至少需要两个CPU才能测试核间延迟" << std::endl;
+        return 0;
+    }
+
+    std::cout << "\n每对CPU往返 " << ROUND_TRIP_COUNT << " 次、传递 " << STREAM_COUNT << " 条消息，共 "
+              << cpus.size() * (cpus.size() - 1) << " 对" << std::endl;
+    std::vector<std::vector<PairResult>> results(cpus.size(), std::vector<PairResult>(cpus.size()));
+    int failed_pairs = 0;
+    for (size_t i = 0; i < cpus.size(); ++i) {
+        for (size_t j = 0; j < cpus.size(); ++j) {
+            if (i != j) {
+                bool latency_pinned = false;
+                bool throughput_pinned = false;
+                results[i][j].one_way_ns = round_trip_median_ns(cpus[i], cpus[j], &latency_pinned);
+                results[i][j].throughput = stream_throughput(cpus[i], cpus[j], &throughput_pinned);
+                results[i][j].pinned = latency_pinned && throughput_pinned;
+                failed_pairs += results[i][j].pinned ? 0 : 1;
+            }
+        }
+    }
+
+    print_matrix("单向延迟矩阵 (ns，往返中位数的一半；行为发起方/生产者，列为响应方/消费者)",
+                 cpus, results, &PairResult::one_way_ns, 1.0, 0);
+    print_matrix("吞吐量矩阵 (M msg/s；行为生产者，列为消费者)",
+                 cpus, results, &PairResult::throughput, 1e-6, 1);
+    if (failed_pairs > 0) {
+        std::cout << "\n标!的 " << failed_pairs << " 对CPU设置亲和性失败(CPU离线或被cgroup限制)，"
+                  << "线程未按要求放置，结果已舍弃" << std::endl;
+    }
+
+    recommend(cpus, topology, results);
+
+    return 0;
+}
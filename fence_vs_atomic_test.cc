@@ -7,17 +7,35 @@
 #include <cmath>
 #include "chan_soft_array.h"
 #include "chan_fence.h"
+#include "chan_slot_seq.h"
 
 // 测试参数
 constexpr int TEST_COUNT = 1000000;  // 测试次数
 constexpr int WARMUP_COUNT = 100000; // 预热次数
 constexpr int BENCHMARK_RUNS = 5;    // 基准测试运行次数
+constexpr int SIZE_SWEEP_RUNS = 3;   // 消息大小对比中每种实现的运行次数
 
 // 定义不同实现的类型别名
 using QueueSoftArray64 = SPSCQueueSoftArray<int, 1024, 64>;
 using QueueSoftArray128 = SPSCQueueSoftArray<int, 1024, 128>;
 using QueueFence64 = SPSCQueueFence<int, 1024, 64>;
 using QueueFence128 = SPSCQueueFence<int, 1024, 128>;
+using QueueSlotSeq64 = SPSCQueueSlotSeq<int, 1024, 64>;
+using QueueSlotSeq128 = SPSCQueueSlotSeq<int, 1024, 128>;
+
+// 消息大小对比用的定长消息，可以从int构造以复用同一套吞吐量测试
+template<size_t Bytes>
+struct Message {
+    uint64_t words[Bytes / sizeof(uint64_t)];
+
+    Message() noexcept {}
+    Message(int value) noexcept {
+        words[0] = static_cast<uint64_t>(value);
+        for (size_t i = 1; i < Bytes / sizeof(uint64_t); ++i) {
+            words[i] = words[0] + i;
+        }
+    }
+};
 
 template<typename QueueType>
 double single_throughput_test(QueueType* queue) {
@@ -110,6 +128,40 @@ void benchmark_implementation(QueueType* queue, const std::string& name) {
     std::cout << "  变异系数: " << std::fixed << std::setprecision(2) << (stddev / avg * 100) << "%" << std::endl;
 }
 
+template<typename QueueType>
+double median_throughput(QueueType* queue, int runs) {
+    std::vector<double> throughputs;
+    for (int run = 0; run < runs; ++run) {
+        throughputs.push_back(single_throughput_test(queue));
+    }
+    std::sort(throughputs.begin(), throughputs.end());
+    return throughputs[throughputs.size() / 2];
+}
+
+// 同一消息大小下三种引擎的中位数吞吐量，标出最快的一种
+template<size_t Bytes>
+void benchmark_message_size() {
+    using Payload = Message<Bytes>;
+    auto* soft = SPSCQueueSoftArray<Payload, 1024, 64>::create();
+    auto* fence = SPSCQueueFence<Payload, 1024, 64>::create();
+    auto* slot_seq = SPSCQueueSlotSeq<Payload, 1024, 64>::create();
+
+    const char* names[] = {"SoftArray", "Fence", "SlotSeq"};
+    double results[] = {median_throughput(soft, SIZE_SWEEP_RUNS),
+                        median_throughput(fence, SIZE_SWEEP_RUNS),
+                        median_throughput(slot_seq, SIZE_SWEEP_RUNS)};
+    size_t const best = std::max_element(std::begin(results), std::end(results)) - std::begin(results);
+
+    std::cout << std::setw(8) << Bytes << " | " << std::fixed << std::setprecision(0)
+              << std::setw(12) << results[0] << " | "
+              << std::setw(12) << results[1] << " | "
+              << std::setw(12) << results[2] << " | " << names[best] << std::endl;
+
+    SPSCQueueSoftArray<Payload, 1024, 64>::destroy(soft);
+    SPSCQueueFence<Payload, 1024, 64>::destroy(fence);
+    SPSCQueueSlotSeq<Payload, 1024, 64>::destroy(slot_seq);
+}
+
 void print_system_info() {
     std::cout << "\n=== 系统信息 ===" << std::endl;
     
@@ -136,8 +188,11 @@ int main() {
     auto* queue_soft_128 = QueueSoftArray128::create();
     auto* queue_fence_64 = QueueFence64::create();
     auto* queue_fence_128 = QueueFence128::create();
+    auto* queue_slot_64 = QueueSlotSeq64::create();
+    auto* queue_slot_128 = QueueSlotSeq128::create();
     
-    if (!queue_soft_64 || !queue_soft_128 || !queue_fence_64 || !queue_fence_128) {
+    if (!queue_soft_64 || !queue_soft_128 || !queue_fence_64 || !queue_fence_128 ||
+        !queue_slot_64 || !queue_slot_128) {
         std::cerr << "队列创建失败!" << std::endl;
         return 1;
     }
@@ -149,6 +204,16 @@ int main() {
     benchmark_implementation(queue_soft_128, "SoftArray + Atomic (128字节缓存行)");
     benchmark_implementation(queue_fence_64, "Fence实现 (64字节缓存行)");
     benchmark_implementation(queue_fence_128, "Fence实现 (128字节缓存行)");
+    benchmark_implementation(queue_slot_64, "槽位序号实现 (64字节缓存行)");
+    benchmark_implementation(queue_slot_128, "槽位序号实现 (128字节缓存行)");
+
+    // 不同消息大小下的对比，按消息大小选择更快的引擎
+    std::cout << "\n=== 消息大小对比 (中位数吞吐量 ops/sec，" << SIZE_SWEEP_RUNS << "次) ===" << std::endl;
+    std::cout << "消息字节 |    SoftArray |        Fence |      SlotSeq | 最快" << std::endl;
+    std::cout << "---------|--------------|--------------|--------------|---------" << std::endl;
+    benchmark_message_size<8>();
+    benchmark_message_size<64>();
+    benchmark_message_size<256>();
     
     // 内存使用情况分析
     std::cout << "\n=== 内存使用分析 ===" << std::endl;
@@ -156,6 +221,8 @@ int main() {
     std::cout << "SoftArray128 对象大小: " << sizeof(QueueSoftArray128) << " 字节" << std::endl;
     std::cout << "Fence64 对象大小: " << sizeof(QueueFence64) << " 字节" << std::endl;
     std::cout << "Fence128 对象大小: " << sizeof(QueueFence128) << " 字节" << std::endl;
+    std::cout << "SlotSeq64 对象大小: " << sizeof(QueueSlotSeq64) << " 字节 (每个槽位多一个4字节序号)" << std::endl;
+    std::cout << "SlotSeq128 对象大小: " << sizeof(QueueSlotSeq128) << " 字节" << std::endl;
     
     // 技术分析
     std::cout << "\n=== 技术分析 ===" << std::endl;
@@ -168,16 +235,24 @@ int main() {
     std::cout << "  + 可能在某些特定场景下有性能优势" << std::endl;
     std::cout << "  - 平台相关性强，可移植性较差" << std::endl;
     std::cout << "  - 需要深入理解CPU内存模型" << std::endl;
+    std::cout << "\n槽位序号实现特点:" << std::endl;
+    std::cout << "  + 没有共享的head_/tail_，两端只共享数据所在的缓存行" << std::endl;
+    std::cout << "  + 消费者读取序号的同一次未命中就拿到了数据" << std::endl;
+    std::cout << "  - 每个槽位多一个序号，小消息的内存占用明显增加" << std::endl;
+    std::cout << "  - 两端距离很近时，同一数据行会在两个核心间来回传递" << std::endl;
     
     // 清理资源
     QueueSoftArray64::destroy(queue_soft_64);
     QueueSoftArray128::destroy(queue_soft_128);
     QueueFence64::destroy(queue_fence_64);
     QueueFence128::destroy(queue_fence_128);
+    QueueSlotSeq64::destroy(queue_slot_64);
+    QueueSlotSeq128::destroy(queue_slot_128);
     
     std::cout << "\n=== 结论建议 ===" << std::endl;
     std::cout << "• 对于生产环境，推荐使用Atomic实现" << std::endl;
     std::cout << "• Fence实现可作为研究和学习CPU内存模型的参考" << std::endl;
+    std::cout << "• 槽位序号实现适合按消息大小对比后选用，参考上面的消息大小对比表" << std::endl;
     std::cout << "• 具体选择应基于实际性能测试结果" << std::endl;
     
     return 0;
@@ -0,0 +1,166 @@
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <iomanip>
+#include <algorithm>
+#include "chan_soft_array.h"
+#include "chan_alloc.h"
+
+// 测试参数
+constexpr size_t MIN_MESSAGES = 4 * 1024 * 1024;   // 每轮至少传递的消息数
+constexpr size_t BATCH = 256;                       // push_n/pop_n批量大小，减少索引开销、突出访存开销
+
+// 消费者累加出的和，与生产者的序号和比较以验证数据
+struct SweepResult {
+    double ns_per_message;
+    double throughput;        // msgs/sec
+    bool verified;
+};
+
+// 从/proc/self/smaps读取包含addr的映射中已经由大页承载的字节数(AnonHugePages + Hugetlb)
+static size_t huge_bytes_backing(const void* addr) {
+    std::ifstream smaps("/proc/self/smaps");
+    uintptr_t const target = reinterpret_cast<uintptr_t>(addr);
+    std::string line;
+    bool in_mapping = false;
+    size_t huge_kb = 0;
+    while (std::getline(smaps, line)) {
+        uintptr_t start = 0, end = 0;
+        char dash = 0;
+        std::istringstream header(line);
+        if (header >> std::hex >> start >> dash >> end && dash == '-') {
+            if (in_mapping) {
+                break;
+            }
+            in_mapping = target >= start && target < end;
+            continue;
+        }
+        if (!in_mapping) {
+            continue;
+        }
+        std::istringstream field(line);
+        std::string key;
+        size_t kb = 0;
+        field >> key >> kb;
+        if (key == "AnonHugePages:" || key == "Private_Hugetlb:" || key == "Shared_Hugetlb:") {
+            huge_kb += kb;
+        }
+    }
+    return huge_kb * 1024;
+}
+
+template<uint32_t Capacity>
+SweepResult run_sweep(ChanAlloc::PageSize requested, ChanAlloc::PageSize& used, size_t& huge_bytes) {
+    using Queue = SPSCQueueSoftArray<uint64_t, Capacity>;
+    ChanAlloc::Options options;
+    options.page_size = requested;
+    auto* queue = Queue::create(options);
+    if (!queue) {
+        std::cerr << "create失败" << std::endl;
+        exit(1);
+    }
+    used = queue->page_size();
+
+    // 至少绕环几圈，让每一页都被反复访问
+    size_t const messages = std::max(MIN_MESSAGES, static_cast<size_t>(Capacity) * 4) / BATCH * BATCH;
+    uint64_t consumer_sum = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([queue, messages]() {
+        uint64_t batch[BATCH];
+        for (size_t sent = 0; sent < messages; sent += BATCH) {
+            for (size_t i = 0; i < BATCH; ++i) {
+                batch[i] = sent + i;
+            }
+            size_t pushed = 0;
+            while (pushed < BATCH) {
+                pushed += queue->push_n(batch + pushed, BATCH - pushed);
+            }
+        }
+    });
+
+    std::thread consumer([queue, messages, &consumer_sum]() {
+        uint64_t batch[BATCH];
+        uint64_t sum = 0;
+        size_t received = 0;
+        while (received < messages) {
+            size_t n = queue->pop_n(batch, BATCH);
+            for (size_t i = 0; i < n; ++i) {
+                sum += batch[i];
+            }
+            received += n;
+        }
+        consumer_sum = sum;
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    huge_bytes = huge_bytes_backing(queue);
+    Queue::destroy(queue);
+
+    uint64_t const expected = static_cast<uint64_t>(messages) * (messages - 1) / 2;
+    return {elapsed_ns / messages, messages * 1e9 / elapsed_ns, consumer_sum == expected};
+}
+
+template<uint32_t Capacity>
+void sweep_ring_size(const char* level) {
+    const ChanAlloc::PageSize modes[] = {
+        ChanAlloc::PageSize::kSmall, ChanAlloc::PageSize::kTransparentHuge,
+        ChanAlloc::PageSize::kHuge2M, ChanAlloc::PageSize::kHuge1G};
+
+    size_t const ring_bytes = sizeof(uint64_t) * Capacity;
+    for (auto mode : modes) {
+        ChanAlloc::PageSize used;
+        size_t huge_bytes = 0;
+        SweepResult r = run_sweep<Capacity>(mode, used, huge_bytes);
+        std::cout << std::setw(9) << Capacity << " | "
+                  << std::setw(8) << ring_bytes / 1024 << " | "
+                  << std::setw(5) << level << " | "
+                  << std::setw(4) << ChanAlloc::page_size_name(mode) << " -> "
+                  << std::setw(3) << ChanAlloc::page_size_name(used) << " | "
+                  << std::setw(8) << huge_bytes / 1024 << " | "
+                  << std::fixed << std::setprecision(2) << std::setw(8) << r.ns_per_message << " | "
+                  << std::setprecision(0) << std::setw(12) << r.throughput << " | "
+                  << (r.verified ? "✓" : "✗") << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "SPSC 队列大页内存基准测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+    std::cout << "元素类型: uint64_t，批量大小: " << BATCH << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+
+    std::ifstream thp("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string thp_mode;
+    std::getline(thp, thp_mode);
+    std::cout << "透明大页设置: " << (thp_mode.empty() ? "不可用" : thp_mode) << std::endl;
+    std::ifstream nr_hugepages("/proc/sys/vm/nr_hugepages");
+    std::string reserved;
+    std::getline(nr_hugepages, reserved);
+    std::cout << "预留的2MB大页数: " << (reserved.empty() ? "不可用" : reserved) << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "     槽位 | 环大小KB | 层级  |  请求 -> 实际 | 大页KB   | ns/消息  |  吞吐(msg/s) | 校验" << std::endl;
+    std::cout << "----------|----------|-------|---------------|----------|----------|--------------|-----" << std::endl;
+
+    sweep_ring_size<(1u << 12)>("L1");      // 32KB
+    sweep_ring_size<(1u << 15)>("L2");      // 256KB
+    sweep_ring_size<(1u << 18)>("LLC");     // 2MB
+    sweep_ring_size<(1u << 21)>("LLC+");    // 16MB
+    sweep_ring_size<(1u << 24)>("DRAM");    // 128MB
+
+    std::cout << std::endl;
+    std::cout << "说明:" << std::endl;
+    std::cout << "• 实际页面类型在MAP_HUGETLB预留不足时依次退化: 1GB -> 2MB -> THP" << std::endl;
+    std::cout << "• 大页KB取自/proc/self/smaps，THP模式下为内核实际合并成大页的部分" << std::endl;
+    std::cout << "• 环能放进L1/L2时TLB覆盖充足，大页收益主要出现在LLC以外的环大小" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include <iostream>
+#include <thread>
+#include <iomanip>
+#include <string>
+#include "chan.h"
+#include "chan_soft_array.h"
+#include "chan_fence.h"
+#include "chan_pow2.h"
+#include "chan_slot_seq.h"
+#include "chan_clock.h"
+#include "chan_stats.h"
+
+// 测试参数
+constexpr int ONE_WAY_COUNT = 200000;     // 单向延迟测试消息数
+constexpr int ROUND_TRIP_COUNT = 100000;  // 往返延迟测试次数
+constexpr int WARMUP_COUNT = 10000;       // 每项测试前丢弃的消息数
+constexpr int SEND_INTERVAL_NS = 2000;    // 单向测试中生产者的发送间隔，避免消息在队列中堆积
+constexpr uint32_t QUEUE_SIZE = 1024;
+
+// 每条消息携带序号和发送时刻的TSC
+struct Stamp {
+    uint64_t sequence;
+    uint64_t send_ticks;
+};
+
+// 单向延迟：生产者按固定间隔发送，消费者在取到消息时读取TSC，记录与发送时刻之差
+// (依赖各核心TSC同步，近年的x86服务器都满足)
+template<typename Queue>
+ChanStats::LatencyHistogram one_way_latency(Queue* queue) {
+    ChanStats::LatencyHistogram histogram;
+    uint64_t const interval_ticks = ChanClock::ns_to_ticks(SEND_INTERVAL_NS);
+
+    std::thread producer([queue, interval_ticks]() {
+        ChanStats::pin_to_cpu(0);
+        uint64_t next_send = ChanClock::ticks();
+        for (int i = 0; i < WARMUP_COUNT + ONE_WAY_COUNT; ++i) {
+            while (ChanClock::ticks() < next_send) {
+                ChanStats::idle();  // 忙等到发送时间点
+            }
+            next_send += interval_ticks;
+            // 按间隔发送时队列不会满，阻塞的push不会真正等待
+            queue->push(Stamp{static_cast<uint64_t>(i), ChanClock::ticks()});
+        }
+    });
+
+    std::thread consumer([queue, &histogram]() {
+        ChanStats::pin_to_cpu(1);
+        for (int i = 0; i < WARMUP_COUNT + ONE_WAY_COUNT; ++i) {
+            Stamp const stamp = ChanStats::receive(queue);
+            uint64_t const now = ChanClock::ticks();
+            if (i >= WARMUP_COUNT) {
+                histogram.record(now - stamp.send_ticks);
+            }
+        }
+    });
+
+    producer.join();
+    consumer.join();
+    return histogram;
+}
+
+// 往返延迟：发起方经ping发送，响应方从ping取出后原样经pong发回，发起方记录整个往返
+template<typename Queue>
+ChanStats::LatencyHistogram round_trip_latency(Queue* ping, Queue* pong) {
+    ChanStats::LatencyHistogram histogram;
+
+    std::thread responder([ping, pong]() {
+        ChanStats::pin_to_cpu(1);
+        for (int i = 0; i < WARMUP_COUNT + ROUND_TRIP_COUNT; ++i) {
+            pong->push(ChanStats::receive(ping));
+        }
+    });
+
+    std::thread initiator([ping, pong, &histogram]() {
+        ChanStats::pin_to_cpu(0);
+        for (int i = 0; i < WARMUP_COUNT + ROUND_TRIP_COUNT; ++i) {
+            uint64_t const start = ChanClock::ticks();
+            ping->push(Stamp{static_cast<uint64_t>(i), start});
+            ChanStats::receive(pong);
+            uint64_t const end = ChanClock::ticks();
+            if (i >= WARMUP_COUNT) {
+                histogram.record(end - start);
+            }
+        }
+    });
+
+    initiator.join();
+    responder.join();
+    return histogram;
+}
+
+static void print_row(const std::string& name, const char* mode, const ChanStats::LatencyHistogram& h) {
+    std::cout << std::setw(20) << name << " | " << std::setw(4) << mode << " | "
+              << std::fixed << std::setprecision(0)
+              << std::setw(7) << ChanClock::ticks_to_ns(static_cast<uint64_t>(h.mean())) << " | "
+              << std::setw(7) << h.percentile_ns(50) << " | "
+              << std::setw(7) << h.percentile_ns(90) << " | "
+              << std::setw(7) << h.percentile_ns(99) << " | "
+              << std::setw(8) << h.percentile_ns(99.9) << " | "
+              << std::setw(8) << h.percentile_ns(99.99) << " | "
+              << std::setw(9) << ChanClock::ticks_to_ns(h.max()) << std::endl;
+}
+
+// 以create()/destroy()创建的实现
+template<typename Queue>
+void benchmark_engine(const std::string& name) {
+    auto* queue = Queue::create();
+    auto* pong = Queue::create();
+    if (!queue || !pong) {
+        std::cerr << "队列创建失败: " << name << std::endl;
+        exit(1);
+    }
+    print_row(name, "单向", one_way_latency(queue));
+    print_row(name, "往返", round_trip_latency(queue, pong));
+    Queue::destroy(queue);
+    Queue::destroy(pong);
+}
+
+// 原始实现是普通对象，容量在运行时指定
+void benchmark_original(const std::string& name) {
+    SPSCQueue<Stamp> queue(QUEUE_SIZE - 1);
+    SPSCQueue<Stamp> pong(QUEUE_SIZE - 1);
+    print_row(name, "单向", one_way_latency(&queue));
+    print_row(name, "往返", round_trip_latency(&queue, &pong));
+}
+
+int main() {
+    std::cout << "SPSC 队列延迟分布基准测试 (TSC时间戳 + 对数-线性直方图)" << std::endl;
+    std::cout << "=======================================================" << std::endl;
+    std::cout << "单向测试消息数: " << ONE_WAY_COUNT << " (发送间隔 " << SEND_INTERVAL_NS << " 纳秒)"
+              << "，往返测试次数: " << ROUND_TRIP_COUNT << "，预热: " << WARMUP_COUNT << std::endl;
+    std::cout << "TSC频率: " << std::fixed << std::setprecision(3) << ChanClock::ticks_per_ns() << " tick/ns"
+              << "，直方图相对误差 < "
+              << std::setprecision(1) << 200.0 / ChanStats::LatencyHistogram::kSubBuckets << "%" << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+    if (std::thread::hardware_concurrency() < 2) {
+        ChanStats::yield_when_idle = true;
+        std::cout << "只有一个CPU: 等待时让出CPU，结果主要反映线程切换开销" << std::endl;
+    } else {
+        std::cout << "生产者/发起方固定在CPU 0，消费者/响应方固定在CPU 1" << std::endl;
+    }
+
+    std::cout << "\n单位: 纳秒" << std::endl;
+    std::cout << "                实现 | 模式 |    平均 |     p50 |     p90 |     p99 |    p99.9 |   p99.99 |       最大" << std::endl;
+    std::cout << "---------------------|------|---------|---------|---------|---------|----------|----------|-----------" << std::endl;
+
+    benchmark_original("SPSCQueue");
+    benchmark_engine<SPSCQueueSoftArray<Stamp, QUEUE_SIZE, 64>>("SoftArray (64)");
+    benchmark_engine<SPSCQueueSoftArray<Stamp, QUEUE_SIZE, 128>>("SoftArray (128)");
+    benchmark_engine<SPSCQueueFence<Stamp, QUEUE_SIZE, 64>>("Fence (64)");
+    benchmark_engine<SPSCQueueFence<Stamp, QUEUE_SIZE, 128>>("Fence (128)");
+    benchmark_engine<SPSCQueuePow2<Stamp, QUEUE_SIZE, 64>>("Pow2 (64)");
+    benchmark_engine<SPSCQueuePow2<Stamp, QUEUE_SIZE, 128>>("Pow2 (128)");
+    benchmark_engine<SPSCQueueSlotSeq<Stamp, QUEUE_SIZE, 64>>("SlotSeq (64)");
+    benchmark_engine<SPSCQueueSlotSeq<Stamp, QUEUE_SIZE, 128>>("SlotSeq (128)");
+
+    std::cout << std::endl;
+    std::cout << "说明:" << std::endl;
+    std::cout << "• 每条消息都单独计时并记入直方图，百分位取所在桶的上界，不会低估尾延迟" << std::endl;
+    std::cout << "• 单向延迟依赖各核心TSC同步；往返延迟只用发起方一个核心的TSC，不受此影响" << std::endl;
+    std::cout << "• 单向测试按固定间隔发送，测的是队列不堆积时的传递延迟，不是饱和吞吐下的排队延迟" << std::endl;
+
+    return 0;
+}
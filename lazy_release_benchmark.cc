@@ -0,0 +1,137 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include "chan.h"
+#include "chan_soft_array.h"
+#include "chan_fence.h"
+
+// 测试参数
+constexpr int TEST_COUNT = 2000000;     // 每轮传递的消息数
+constexpr int BENCHMARK_RUNS = 3;       // 每个配置运行次数，取中位数
+constexpr uint32_t QUEUE_SIZE = 1024;
+constexpr uint32_t RELEASE_INTERVALS[] = {1, 4, 16, 64};  // pop_deferred的发布间隔
+
+using AtomicQueue = SPSCQueue<uint64_t>;
+using SoftArrayQueue = SPSCQueueSoftArray<uint64_t, QUEUE_SIZE>;
+using FenceQueue = SPSCQueueFence<uint64_t, QUEUE_SIZE>;
+
+struct LazyResult {
+    double throughput;        // msgs/sec
+    uint64_t tail_releases;   // 消费者发布tail_的次数
+    bool verified;
+};
+
+// 生产者逐个push，消费者逐个try_pop_deferred；
+// 通过pending_pops()归零的时刻统计tail_的发布次数，每次发布都会让生产者的tail_副本失效一次，
+// 生产者下次需要检查空位时就要把这一行从消费者核心重新拉回来
+template<typename Queue>
+LazyResult run_once(Queue& queue, uint32_t interval) {
+    queue.set_release_interval(interval);
+    LazyResult result{};
+    uint64_t consumer_sum = 0;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::thread producer([&queue]() {
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            queue.push(static_cast<uint64_t>(i));
+        }
+    });
+    std::thread consumer([&queue, &result, &consumer_sum]() {
+        uint64_t value;
+        uint64_t sum = 0;
+        uint64_t releases = 0;
+        int received = 0;
+        while (received < TEST_COUNT) {
+            uint32_t const pending_before = queue.pending_pops();
+            bool const got = queue.try_pop_deferred(value);
+            if (queue.pending_pops() == 0 && (got || pending_before)) {
+                ++releases;
+            }
+            if (got) {
+                sum += value;
+                ++received;
+            }
+        }
+        if (queue.pending_pops()) {
+            queue.flush_tail();
+            ++releases;
+        }
+        result.tail_releases = releases;
+        consumer_sum = sum;
+    });
+    producer.join();
+    consumer.join();
+    auto end_time = std::chrono::high_resolution_clock::now();
+
+    result.throughput = TEST_COUNT * 1e9 /
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    uint64_t const expected = static_cast<uint64_t>(TEST_COUNT) * (TEST_COUNT - 1) / 2;
+    result.verified = consumer_sum == expected;
+    return result;
+}
+
+template<typename Queue>
+void benchmark_queue(Queue& queue, const std::string& name) {
+    double baseline = 0;
+    for (uint32_t interval : RELEASE_INTERVALS) {
+        std::vector<double> throughputs;
+        uint64_t releases = 0;
+        bool verified = true;
+        for (int run = 0; run < BENCHMARK_RUNS; ++run) {
+            LazyResult r = run_once(queue, interval);
+            throughputs.push_back(r.throughput);
+            releases += r.tail_releases;
+            verified &= r.verified;
+        }
+        std::sort(throughputs.begin(), throughputs.end());
+        double const median = throughputs[throughputs.size() / 2];
+        if (interval == 1) {
+            baseline = median;
+        }
+        double const releases_per_million = releases * 1e6 / (static_cast<double>(TEST_COUNT) * BENCHMARK_RUNS);
+
+        std::cout << std::setw(18) << name << " | "
+                  << std::setw(4) << interval << " | "
+                  << std::fixed << std::setprecision(0) << std::setw(14) << median << " | "
+                  << std::setprecision(2) << std::setw(6) << median / baseline << "x | "
+                  << std::setprecision(0) << std::setw(16) << releases_per_million << " | "
+                  << (verified ? "✓" : "✗") << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "SPSC 队列消费者延迟释放tail_基准测试" << std::endl;
+    std::cout << "====================================" << std::endl;
+    std::cout << "每轮消息数: " << TEST_COUNT << "，运行次数: " << BENCHMARK_RUNS
+              << "，队列容量: " << QUEUE_SIZE << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "              队列 | 间隔 |  吞吐量(msg/s) | 相对N=1 | tail_发布/百万消息 | 校验" << std::endl;
+    std::cout << "-------------------|------|----------------|---------|-------------------|-----" << std::endl;
+
+    auto* atomic_queue = new AtomicQueue(QUEUE_SIZE - 1);
+    benchmark_queue(*atomic_queue, "SPSCQueue");
+    delete atomic_queue;
+
+    auto* soft_array_queue = SoftArrayQueue::create();
+    benchmark_queue(*soft_array_queue, "SPSCQueueSoftArray");
+    SoftArrayQueue::destroy(soft_array_queue);
+
+    auto* fence_queue = FenceQueue::create();
+    benchmark_queue(*fence_queue, "SPSCQueueFence");
+    FenceQueue::destroy(fence_queue);
+
+    std::cout << std::endl;
+    std::cout << "说明:" << std::endl;
+    std::cout << "• 间隔N表示每N次pop_deferred才release store一次tail_，N=1与逐个pop相同" << std::endl;
+    std::cout << "• tail_发布次数即生产者持有的tail_缓存行被失效的次数上限，"
+              << "队列为空或接近满时会提前发布，实际次数可能多于消息数/N" << std::endl;
+    std::cout << "• 收益来自减少跨核缓存行传输，需要生产者和消费者运行在不同核心上才能体现" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+#include <iostream>
+#include <thread>
+#include <iomanip>
+#include <random>
+#include <string>
+#include "chan.h"
+#include "chan_soft_array.h"
+#include "chan_fence.h"
+#include "chan_pow2.h"
+#include "chan_slot_seq.h"
+#include "chan_clock.h"
+#include "chan_stats.h"
+
+// 测试参数
+constexpr int SATURATION_COUNT = 2000000;   // 测量饱和吞吐时传递的消息数
+constexpr double POINT_SECONDS = 0.1;       // 每个负载点按目标速率发送的时长
+constexpr uint32_t QUEUE_SIZE = 1024;
+constexpr uint32_t BURST_PERIOD_NS = 1000000;  // 突发模式的周期: 1ms
+constexpr double BURST_DUTY = 0.2;             // 突发模式中发送的时间占比
+
+// 负载点：饱和吞吐的百分比，包括超过饱和的点
+constexpr double LOAD_LEVELS[] = {0.1, 0.25, 0.5, 0.75, 0.9, 1.0, 1.1, 1.25};
+
+// 消息同时带上计划发送时刻和实际发送时刻：
+// 按计划时刻计算的延迟包含了生产者被阻塞而推迟发送的时间，不受协调遗漏(coordinated omission)影响
+struct Sample {
+    uint64_t intended_ticks;
+    uint64_t sent_ticks;
+};
+
+// 到达过程：依次给出每条消息相对开始时刻的计划发送时间(tick，用double累加避免舍入误差累积)
+enum class Arrival {
+    CONSTANT,  // 固定间隔
+    POISSON,   // 指数分布间隔，平均速率与固定间隔相同
+    BURSTY,    // 每个周期前BURST_DUTY的时间内以 速率 / BURST_DUTY 发送，其余时间静默
+};
+
+const char* arrival_name(Arrival arrival) {
+    switch (arrival) {
+        case Arrival::CONSTANT: return "固定速率";
+        case Arrival::POISSON: return "泊松到达";
+        case Arrival::BURSTY: return "突发开关";
+    }
+    return "";
+}
+
+class ArrivalSchedule {
+public:
+    ArrivalSchedule(Arrival arrival, double rate) noexcept
+        : arrival_(arrival), random_(12345), exponential_(1.0) {
+        double const ticks_per_second = ChanClock::ticks_per_ns() * 1e9;
+        mean_gap_ = ticks_per_second / rate;
+        burst_gap_ = mean_gap_ * BURST_DUTY;
+        period_ = ChanClock::ticks_per_ns() * BURST_PERIOD_NS;
+        on_length_ = period_ * BURST_DUTY;
+    }
+
+    double next() noexcept {
+        double const current = time_;
+        switch (arrival_) {
+            case Arrival::CONSTANT:
+                time_ += mean_gap_;
+                break;
+            case Arrival::POISSON:
+                time_ += exponential_(random_) * mean_gap_;
+                break;
+            case Arrival::BURSTY:
+                time_ += burst_gap_;
+                if (time_ - period_start_ >= on_length_) {
+                    // 本周期的发送窗口用完，跳到下一个周期开头
+                    period_start_ += period_;
+                    time_ = period_start_;
+                }
+                break;
+        }
+        return current;
+    }
+
+private:
+    Arrival arrival_;
+    std::mt19937_64 random_;
+    std::exponential_distribution<double> exponential_;
+    double mean_gap_;
+    double burst_gap_;
+    double period_;
+    double on_length_;
+    double time_ = 0.0;
+    double period_start_ = 0.0;
+};
+
+// 闭环测量饱和吞吐：生产者尽快发送，作为各负载点的基准
+template<typename Queue>
+double saturation_throughput(Queue* queue) {
+    uint64_t const start = ChanClock::ticks();
+
+    std::thread producer([queue]() {
+        ChanStats::pin_to_cpu(0);
+        for (int i = 0; i < SATURATION_COUNT; ++i) {
+            queue->push(Sample{0, 0});
+        }
+    });
+
+    std::thread consumer([queue]() {
+        ChanStats::pin_to_cpu(1);
+        for (int i = 0; i < SATURATION_COUNT; ++i) {
+            ChanStats::receive(queue);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    double const elapsed_ns = ChanClock::ticks_to_ns(ChanClock::ticks() - start);
+    return SATURATION_COUNT * 1e9 / elapsed_ns;
+}
+
+struct LoadPoint {
+    double achieved_rate;                          // msgs/sec
+    ChanStats::LatencyHistogram from_intended;     // 按计划发送时刻
+    ChanStats::LatencyHistogram from_sent;         // 按实际发送时刻(闭环测量看到的延迟)
+};
+
+// 开环测量：生产者按计划时刻发送，落后于计划时立即补发，不会因为队列满而少发
+template<typename Queue>
+void offered_load(Queue* queue, Arrival arrival, double rate, LoadPoint* point) {
+    uint64_t const messages = static_cast<uint64_t>(rate * POINT_SECONDS);
+    uint64_t const start = ChanClock::ticks();
+
+    std::thread producer([queue, arrival, rate, messages, start]() {
+        ChanStats::pin_to_cpu(0);
+        ArrivalSchedule schedule(arrival, rate);
+        for (uint64_t i = 0; i < messages; ++i) {
+            uint64_t const intended = start + static_cast<uint64_t>(schedule.next());
+            uint64_t now;
+            while ((now = ChanClock::ticks()) < intended) {
+                ChanStats::idle();
+            }
+            queue->push(Sample{intended, now});
+        }
+    });
+
+    std::thread consumer([queue, messages, point]() {
+        ChanStats::pin_to_cpu(1);
+        for (uint64_t i = 0; i < messages; ++i) {
+            Sample const sample = ChanStats::receive(queue);
+            uint64_t const now = ChanClock::ticks();
+            point->from_intended.record(now - sample.intended_ticks);
+            point->from_sent.record(now - sample.sent_ticks);
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    double const elapsed_ns = ChanClock::ticks_to_ns(ChanClock::ticks() - start);
+    point->achieved_rate = messages * 1e9 / elapsed_ns;
+}
+
+static void print_point(double level, double rate, const LoadPoint& point) {
+    std::cout << std::fixed << std::setprecision(0)
+              << std::setw(5) << level * 100 << "% | "
+              << std::setw(11) << rate << " | "
+              << std::setw(11) << point.achieved_rate << " | "
+              << std::setw(9) << point.from_intended.percentile_ns(50) << " | "
+              << std::setw(9) << point.from_intended.percentile_ns(99) << " | "
+              << std::setw(10) << point.from_intended.percentile_ns(99.9) << " | "
+              << std::setw(10) << ChanClock::ticks_to_ns(point.from_intended.max()) << " | "
+              << std::setw(10) << point.from_sent.percentile_ns(99) << std::endl;
+}
+
+// 一种实现在一种到达过程下的延迟-负载曲线
+template<typename Queue>
+void load_curve(Queue* queue, const std::string& name, Arrival arrival, double saturation) {
+    std::cout << "\n" << name << " / " << arrival_name(arrival)
+              << " (饱和吞吐 " << std::fixed << std::setprecision(0) << saturation << " msg/s)" << std::endl;
+    std::cout << "  负载 | 目标(msg/s) | 实际(msg/s) |   p50(ns) |   p99(ns) |  p99.9(ns) |   最大(ns) | p99按实际发送" << std::endl;
+    std::cout << "-------|-------------|-------------|-----------|-----------|------------|------------|--------------" << std::endl;
+    for (double const level : LOAD_LEVELS) {
+        double const rate = saturation * level;
+        // 直方图较大，放在堆上
+        auto* point = new LoadPoint();
+        offered_load(queue, arrival, rate, point);
+        print_point(level, rate, *point);
+        delete point;
+    }
+}
+
+template<typename Queue>
+void benchmark_queue(Queue* queue, const std::string& name) {
+    double const saturation = saturation_throughput(queue);
+    for (Arrival arrival : {Arrival::CONSTANT, Arrival::POISSON, Arrival::BURSTY}) {
+        load_curve(queue, name, arrival, saturation);
+    }
+}
+
+// 以create()/destroy()创建的实现
+template<typename Queue>
+void benchmark_engine(const std::string& name) {
+    auto* queue = Queue::create();
+    if (!queue) {
+        std::cerr << "队列创建失败: " << name << std::endl;
+        exit(1);
+    }
+    benchmark_queue(queue, name);
+    Queue::destroy(queue);
+}
+
+int main() {
+    std::cout << "SPSC 队列开环负载测试 (延迟-负载曲线)" << std::endl;
+    std::cout << "=====================================" << std::endl;
+    std::cout << "每个负载点发送 " << POINT_SECONDS << " 秒，负载为各实现闭环饱和吞吐的百分比" << std::endl;
+    std::cout << "突发模式: 每 " << BURST_PERIOD_NS / 1000 << " 微秒中前 " << BURST_DUTY * 100
+              << "% 的时间发送，峰值速率为平均速率的 " << 1.0 / BURST_DUTY << " 倍" << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+    if (std::thread::hardware_concurrency() < 2) {
+        ChanStats::yield_when_idle = true;
+        std::cout << "只有一个CPU: 等待时让出CPU，结果主要反映线程切换开销" << std::endl;
+    } else {
+        std::cout << "生产者固定在CPU 0，消费者固定在CPU 1" << std::endl;
+    }
+
+    {
+        SPSCQueue<Sample> queue(QUEUE_SIZE - 1);
+        benchmark_queue(&queue, "SPSCQueue");
+    }
+    benchmark_engine<SPSCQueueSoftArray<Sample, QUEUE_SIZE, 64>>("SoftArray (64)");
+    benchmark_engine<SPSCQueueSoftArray<Sample, QUEUE_SIZE, 128>>("SoftArray (128)");
+    benchmark_engine<SPSCQueueFence<Sample, QUEUE_SIZE, 64>>("Fence (64)");
+    benchmark_engine<SPSCQueuePow2<Sample, QUEUE_SIZE, 64>>("Pow2 (64)");
+    benchmark_engine<SPSCQueueSlotSeq<Sample, QUEUE_SIZE, 64>>("SlotSeq (64)");
+
+    std::cout << std::endl;
+    std::cout << "说明:" << std::endl;
+    std::cout << "• 延迟从计划发送时刻算起：队列满时生产者被阻塞，后续消息推迟发送的时间也计入延迟" << std::endl;
+    std::cout << "• 最后一列按实际发送时刻计算，即闭环测量会看到的p99，接近饱和时会明显低估" << std::endl;
+    std::cout << "• 超过饱和后队列持续堆积，延迟随测试时长线性增长，实际速率停在饱和吞吐附近" << std::endl;
+
+    return 0;
+}
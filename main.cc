@@ -3,10 +3,13 @@
 #include <chrono>
 #include <atomic>
 #include <cassert>
+#include <cstdlib>
+#include <vector>
 #include "chan.h"
 
 const uint64_t NUM_ELEMENTS = 1 << 20; // 1MB elements
 const int QUEUE_SIZE = 1024; // Queue capacity
+const size_t BATCH_SIZES[] = {32, 64, 128, 256, 512}; // push_n/pop_n batch sizes
 
 std::atomic<bool> producer_done{false};
 
@@ -60,6 +63,116 @@ void consumer(SPSCQueue<uint64_t>& queue) {
     std::cout << "Total elements received: " << received_count << std::endl;
 }
 
+void batch_producer(SPSCQueue<uint64_t>& queue, size_t batch) {
+    std::vector<uint64_t> items(batch);
+    uint64_t next_value = 0;
+    
+    while (next_value < NUM_ELEMENTS) {
+        size_t count = std::min<uint64_t>(batch, NUM_ELEMENTS - next_value);
+        for (size_t i = 0; i < count; ++i) {
+            items[i] = next_value + i;
+        }
+        
+        // push_n may accept only part of the batch when the queue is nearly full
+        size_t sent = 0;
+        while (sent < count) {
+            size_t n = queue.push_n(items.data() + sent, count - sent);
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            sent += n;
+        }
+        next_value += count;
+    }
+}
+
+void batch_consumer(SPSCQueue<uint64_t>& queue, size_t batch) {
+    std::vector<uint64_t> items(batch);
+    uint64_t expected_value = 0;
+    
+    while (expected_value < NUM_ELEMENTS) {
+        size_t n = queue.pop_n(items.data(), batch);
+        if (n == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            // Verify data integrity
+            assert(items[i] == expected_value);
+            expected_value++;
+        }
+    }
+}
+
+// Branch-free integrity check over a contiguous span, auto-vectorized by the compiler
+uint64_t check_sequence(const uint64_t* data, size_t count, uint64_t first_value) {
+    uint64_t mismatch = 0;
+    for (size_t i = 0; i < count; ++i) {
+        mismatch |= data[i] ^ (first_value + i);
+    }
+    return mismatch;
+}
+
+void vectorized_consumer(SPSCQueue<uint64_t>& queue) {
+    uint64_t expected_value = 0;
+    
+    while (expected_value < NUM_ELEMENTS) {
+        // Everything readable, split at the wraparound point
+        auto spans = queue.read_spans();
+        if (spans.empty()) {
+            std::this_thread::yield();
+            continue;
+        }
+        
+        uint64_t mismatch = check_sequence(spans.first.data, spans.first.size, expected_value);
+        mismatch |= check_sequence(spans.second.data, spans.second.size,
+                                   expected_value + spans.first.size);
+        if (mismatch != 0) {
+            std::cerr << "Data integrity check failed near element " << expected_value << std::endl;
+            std::abort();
+        }
+        
+        expected_value += spans.size();
+        queue.release(spans.size());
+    }
+}
+
+void run_vectorized_test() {
+    SPSCQueue<uint64_t> queue(QUEUE_SIZE);
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::thread producer_thread(batch_producer, std::ref(queue), 1);
+    std::thread consumer_thread(vectorized_consumer, std::ref(queue));
+    
+    producer_thread.join();
+    consumer_thread.join();
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    std::cout << "Vectorized consumer: " << duration.count() << " microseconds, "
+              << (NUM_ELEMENTS * 1000000.0 / duration.count()) << " elements/second" << std::endl;
+}
+
+void run_batched_test(size_t batch) {
+    SPSCQueue<uint64_t> queue(QUEUE_SIZE);
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    
+    std::thread producer_thread(batch_producer, std::ref(queue), batch);
+    std::thread consumer_thread(batch_consumer, std::ref(queue), batch);
+    
+    producer_thread.join();
+    consumer_thread.join();
+    
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    
+    std::cout << "Batch " << batch << ": " << duration.count() << " microseconds, "
+              << (NUM_ELEMENTS * 1000000.0 / duration.count()) << " elements/second" << std::endl;
+}
+
 int main() {
     std::cout << "SPSC Queue Performance Test" << std::endl;
     std::cout << "=========================" << std::endl;
@@ -94,5 +207,17 @@ int main() {
     std::cout << "Bandwidth: " << (NUM_ELEMENTS * sizeof(uint64_t) * 1000000.0 / overall_duration.count() / 1024 / 1024) 
               << " MB/s" << std::endl;
     
+    std::cout << std::endl;
+    std::cout << "Batched Performance (push_n/pop_n)" << std::endl;
+    std::cout << "==================================" << std::endl;
+    for (size_t batch : BATCH_SIZES) {
+        run_batched_test(batch);
+    }
+    
+    std::cout << std::endl;
+    std::cout << "Zero-copy Consumer (read_spans/release)" << std::endl;
+    std::cout << "=======================================" << std::endl;
+    run_vectorized_test();
+    
     return 0;
 }
\ No newline at end of file
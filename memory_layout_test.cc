@@ -2,6 +2,90 @@
 #include <iomanip>
 #include "chan.h"
 #include "chan_soft_array.h"
+#include "chan_fence.h"
+
+// Measure where consecutive elements actually land by pushing and reading them back
+template <typename Queue>
+void report_slot_layout(const char* name, uint32_t cache_line) {
+    auto* queue = Queue::create();
+    constexpr int kProbe = 32;
+    const char* addresses[kProbe];
+    for (int i = 0; i < kProbe; ++i) {
+        queue->push(i);
+    }
+    for (int i = 0; i < kProbe; ++i) {
+        addresses[i] = reinterpret_cast<const char*>(queue->front());
+        queue->pop();
+    }
+
+    const uintptr_t first_line = reinterpret_cast<uintptr_t>(addresses[0]) / cache_line;
+    int slots_in_first_line = 0;
+    while (slots_in_first_line < kProbe &&
+           reinterpret_cast<uintptr_t>(addresses[slots_in_first_line]) / cache_line == first_line) {
+        ++slots_in_first_line;
+    }
+    const size_t buffer_offset = addresses[0] - reinterpret_cast<const char*>(queue);
+
+    std::cout << "  " << std::left << std::setw(16) << name << std::right
+              << " object " << std::setw(7) << sizeof(Queue) << " B"
+              << " | slot 0 at +" << std::setw(4) << buffer_offset
+              << " | stride " << std::setw(3) << (addresses[1] - addresses[0]) << " B"
+              << " | slots in first line " << std::setw(2) << slots_in_first_line
+              << " | line jump after slot " << (slots_in_first_line - 1) << ": "
+              << (addresses[slots_in_first_line] - addresses[slots_in_first_line - 1]) << " B"
+              << std::endl;
+    Queue::destroy(queue);
+}
+
+// Print where each index field lands and which cache line it shares
+// Offsets above are relative to the object, so they only hold if create() returns memory
+// aligned to alignof(Queue) (2 lines for IndexDoubleLine). Check a batch of live objects.
+template <typename Queue>
+std::string check_object_alignment() {
+    constexpr int kObjects = 64;
+    Queue* queues[kObjects];
+    int misaligned = 0;
+    for (int i = 0; i < kObjects; ++i) {
+        queues[i] = Queue::create();
+        if (reinterpret_cast<uintptr_t>(queues[i]) % alignof(Queue) != 0) {
+            ++misaligned;
+        }
+    }
+    for (int i = 0; i < kObjects; ++i) {
+        Queue::destroy(queues[i]);
+    }
+    return " | align " + std::to_string(alignof(Queue)) + ": " +
+           (misaligned == 0 ? std::string("OK") :
+            std::to_string(misaligned) + "/" + std::to_string(kObjects) + " MISALIGNED");
+}
+
+template <typename Queue>
+void report_index_layout(const char* name, uint32_t cache_line) {
+    auto* queue = Queue::create();
+    auto const offsets = queue->index_offsets();
+    auto const line = [cache_line](size_t offset) { return offset / cache_line; };
+    std::cout << "  " << std::left << std::setw(16) << name << std::right
+              << " head_ +" << std::setw(4) << offsets.head << " (line " << line(offsets.head) << ")"
+              << " | cached_tail_ +" << std::setw(4) << offsets.cached_tail << " (line " << line(offsets.cached_tail) << ")"
+              << " | tail_ +" << std::setw(4) << offsets.tail << " (line " << line(offsets.tail) << ")"
+              << " | cached_head_ +" << std::setw(4) << offsets.cached_head << " (line " << line(offsets.cached_head) << ")"
+              << " | slot 0 +" << offsets.first_slot
+              << check_object_alignment<Queue>() << std::endl;
+    Queue::destroy(queue);
+}
+
+template <typename Queue>
+void report_fence_index_layout(const char* name, uint32_t cache_line) {
+    auto* queue = Queue::create();
+    auto const offsets = queue->index_offsets();
+    std::cout << "  " << std::left << std::setw(16) << name << std::right
+              << " head_ +" << std::setw(4) << offsets.head << " (line " << offsets.head / cache_line << ")"
+              << " | tail_ +" << std::setw(4) << offsets.tail << " (line " << offsets.tail / cache_line << ")"
+              << " | slot 0 +" << offsets.first_slot
+              << " | object " << sizeof(Queue) << " B"
+              << check_object_alignment<Queue>() << std::endl;
+    Queue::destroy(queue);
+}
 
 int main() {
     std::cout << "SPSC Queue Memory Layout Analysis" << std::endl;
@@ -31,6 +115,40 @@ int main() {
     std::cout << "  Cache locality: Better (single allocation)" << std::endl;
     std::cout << std::endl;
     
+    // Slot layout policies (chan_layout.h)
+    std::cout << "Slot Layout Policies (uint64_t, 1024 slots, 64-byte lines):" << std::endl;
+    report_slot_layout<SPSCQueueSoftArray<uint64_t, 1024, 64, SpinWait, ChanLayout::SlotCompact>>(
+        "SlotCompact", 64);
+    report_slot_layout<SPSCQueueSoftArray<uint64_t, 1024, 64, SpinWait, ChanLayout::SlotGrouped<4>>>(
+        "SlotGrouped<4>", 64);
+    report_slot_layout<SPSCQueueSoftArray<uint64_t, 1024, 64, SpinWait, ChanLayout::SlotPadded>>(
+        "SlotPadded", 64);
+    std::cout << "Slot Layout Policies (int, 1024 slots, 64-byte lines):" << std::endl;
+    report_slot_layout<SPSCQueueSoftArray<int, 1024, 64, SpinWait, ChanLayout::SlotCompact>>(
+        "SlotCompact", 64);
+    report_slot_layout<SPSCQueueSoftArray<int, 1024, 64, SpinWait, ChanLayout::SlotGrouped<8>>>(
+        "SlotGrouped<8>", 64);
+    report_slot_layout<SPSCQueueSoftArray<int, 1024, 64, SpinWait, ChanLayout::SlotPadded>>(
+        "SlotPadded", 64);
+    std::cout << std::endl;
+    
+    // Index layout policies (chan_layout.h)
+    std::cout << "Index Layout Policies (SoftArray, uint64_t, 64-byte lines):" << std::endl;
+    report_index_layout<SPSCQueueSoftArray<uint64_t, 1024, 64, SpinWait, ChanLayout::SlotCompact,
+                                           ChanLayout::IndexSeparate>>("IndexSeparate", 64);
+    report_index_layout<SPSCQueueSoftArray<uint64_t, 1024, 64, SpinWait, ChanLayout::SlotCompact,
+                                           ChanLayout::IndexOwnerLine>>("IndexOwnerLine", 64);
+    report_index_layout<SPSCQueueSoftArray<uint64_t, 1024, 64, SpinWait, ChanLayout::SlotCompact,
+                                           ChanLayout::IndexDoubleLine>>("IndexDoubleLine", 64);
+    std::cout << "Index Layout Policies (Fence, uint64_t, 64-byte lines):" << std::endl;
+    report_fence_index_layout<SPSCQueueFence<uint64_t, 1024, 64, SpinWait,
+                                             ChanLayout::IndexSeparate>>("IndexSeparate", 64);
+    report_fence_index_layout<SPSCQueueFence<uint64_t, 1024, 64, SpinWait,
+                                             ChanLayout::IndexOwnerLine>>("IndexOwnerLine", 64);
+    report_fence_index_layout<SPSCQueueFence<uint64_t, 1024, 64, SpinWait,
+                                             ChanLayout::IndexDoubleLine>>("IndexDoubleLine", 64);
+    std::cout << std::endl;
+    
     // Address analysis
     std::cout << "Memory Address Analysis:" << std::endl;
     std::cout << "========================" << std::endl;
@@ -0,0 +1,222 @@
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <pthread.h>
+#include <sched.h>
+#include "chan_soft_array.h"
+#include "chan_alloc.h"
+
+// 测试参数
+constexpr int TEST_COUNT = 2000000;      // 吞吐量测试消息数
+constexpr int PING_PONG_COUNT = 100000;  // 往返延迟测试次数
+constexpr uint32_t QUEUE_SIZE = 1 << 16; // 512KB的环，超出L2，能体现远端内存访问
+
+using Queue = SPSCQueueSoftArray<uint64_t, QUEUE_SIZE>;
+
+// 解析形如"0-3,8-11"的CPU列表
+static std::vector<int> parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t comma = list.find(',', pos);
+        std::string range = list.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        size_t dash = range.find('-');
+        if (!range.empty()) {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return cpus;
+}
+
+// 每个有CPU的节点及其CPU列表
+static std::vector<std::pair<int, std::vector<int>>> numa_topology() {
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    for (int node = 0; node < ChanAlloc::numa_node_count(); ++node) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (std::getline(file, list)) {
+            std::vector<int> cpus = parse_cpu_list(list);
+            if (!cpus.empty()) {
+                nodes.emplace_back(node, cpus);
+            }
+        }
+    }
+    if (nodes.empty()) {
+        // 没有sysfs节点信息时按单节点、全部CPU处理
+        std::vector<int> cpus;
+        for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+        nodes.emplace_back(0, cpus);
+    }
+    return nodes;
+}
+
+static void pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+struct Endpoint {
+    int node;
+    int cpu;
+};
+
+struct NumaResult {
+    double throughput;     // msgs/sec
+    double rtt_ns;         // 往返延迟均值
+    int buffer_node;       // 环形缓冲区实际所在节点
+    bool bound;
+};
+
+static Queue* create_queue(ChanAlloc::NumaPlacement placement, const Endpoint& producer,
+                           const Endpoint& consumer) {
+    ChanAlloc::Options options;
+    options.numa = placement;
+    options.producer_node = producer.node;
+    options.consumer_node = consumer.node;
+    Queue* queue = Queue::create(options);
+    if (!queue) {
+        std::cerr << "create失败" << std::endl;
+        exit(1);
+    }
+    return queue;
+}
+
+static NumaResult run_placement(ChanAlloc::NumaPlacement placement, const Endpoint& a, const Endpoint& b) {
+    NumaResult result{};
+
+    // 吞吐量：a生产，b消费
+    Queue* queue = create_queue(placement, a, b);
+    result.bound = queue->numa_bound();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    std::thread producer([queue, &a]() {
+        pin_to_cpu(a.cpu);
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            queue->push(static_cast<uint64_t>(i));
+        }
+    });
+    std::thread consumer([queue, &b]() {
+        pin_to_cpu(b.cpu);
+        uint64_t value;
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            queue->pop(value);
+        }
+    });
+    producer.join();
+    consumer.join();
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.throughput = TEST_COUNT * 1e9 /
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    // 缓冲区中部的页，已被生产者写过
+    result.buffer_node = ChanAlloc::node_of(reinterpret_cast<const char*>(queue) + sizeof(Queue) / 2);
+    Queue::destroy(queue);
+
+    // 两端在同一个CPU上时自旋往返只能靠调度切换推进，结果没有意义
+    if (a.cpu == b.cpu) {
+        result.rtt_ns = -1;
+        return result;
+    }
+
+    // 往返延迟：ping由a生产，pong由b生产，每个队列各按自己的生产者/消费者放置
+    Queue* ping = create_queue(placement, a, b);
+    Queue* pong = create_queue(placement, b, a);
+    start_time = std::chrono::high_resolution_clock::now();
+    std::thread initiator([ping, pong, &a]() {
+        pin_to_cpu(a.cpu);
+        uint64_t value;
+        for (int i = 0; i < PING_PONG_COUNT; ++i) {
+            ping->push(static_cast<uint64_t>(i));
+            pong->pop(value);
+        }
+    });
+    std::thread responder([ping, pong, &b]() {
+        pin_to_cpu(b.cpu);
+        uint64_t value;
+        for (int i = 0; i < PING_PONG_COUNT; ++i) {
+            ping->pop(value);
+            pong->push(value);
+        }
+    });
+    initiator.join();
+    responder.join();
+    end_time = std::chrono::high_resolution_clock::now();
+    result.rtt_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count() /
+                    static_cast<double>(PING_PONG_COUNT);
+    Queue::destroy(ping);
+    Queue::destroy(pong);
+    return result;
+}
+
+static void run_pair(const char* label, const Endpoint& a, const Endpoint& b) {
+    std::cout << "\n" << label << ": 生产者 CPU " << a.cpu << " (节点 " << a.node << ")"
+              << "，消费者 CPU " << b.cpu << " (节点 " << b.node << ")" << std::endl;
+    std::cout << "  缓冲区放置  | 生效 | 实际节点 |   吞吐量(msg/s) | 往返延迟(ns)" << std::endl;
+    std::cout << "--------------|------|----------|----------------|-------------" << std::endl;
+
+    const ChanAlloc::NumaPlacement placements[] = {
+        ChanAlloc::NumaPlacement::kDefault, ChanAlloc::NumaPlacement::kProducerNode,
+        ChanAlloc::NumaPlacement::kConsumerNode, ChanAlloc::NumaPlacement::kInterleave};
+    for (auto placement : placements) {
+        NumaResult r = run_placement(placement, a, b);
+        std::cout << std::setw(13) << ChanAlloc::numa_placement_name(placement) << " | "
+                  << std::setw(4) << (r.bound ? "是" : "否") << " | "
+                  << std::setw(8) << r.buffer_node << " | "
+                  << std::fixed << std::setprecision(0) << std::setw(14) << r.throughput << " | "
+                  << std::setprecision(1) << std::setw(11);
+        if (r.rtt_ns < 0) {
+            std::cout << "-" << std::endl;
+        } else {
+            std::cout << r.rtt_ns << std::endl;
+        }
+    }
+}
+
+int main() {
+    std::cout << "SPSC 队列NUMA放置基准测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+    std::cout << "吞吐量测试消息数: " << TEST_COUNT << "，往返测试次数: " << PING_PONG_COUNT << std::endl;
+
+    auto nodes = numa_topology();
+    std::cout << "NUMA节点数: " << nodes.size() << std::endl;
+    for (const auto& node : nodes) {
+        std::cout << "  节点 " << node.first << ": " << node.second.size() << " 个CPU" << std::endl;
+    }
+
+    // 同节点：尽量使用同一节点上的两个不同CPU
+    const auto& first = nodes.front();
+    Endpoint same_a{first.first, first.second.front()};
+    Endpoint same_b{first.first, first.second.size() > 1 ? first.second[1] : first.second.front()};
+    run_pair("同节点", same_a, same_b);
+
+    if (nodes.size() > 1) {
+        const auto& second = nodes[1];
+        run_pair("跨节点", same_a, Endpoint{second.first, second.second.front()});
+    } else {
+        std::cout << "\n只有一个NUMA节点: 跳过跨节点测试，放置请求不会生效(生效列为否)" << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << "说明:" << std::endl;
+    std::cout << "• 放置通过mbind系统调用在首次写入前设置，实际节点通过move_pages查询" << std::endl;
+    std::cout << "• 跨节点时，缓冲区放在消费者一侧通常能减少消费者读取的远端访问，"
+              << "放在生产者一侧则让写入保持本地" << std::endl;
+    std::cout << "• 往返测试中两个队列各自按其生产者/消费者放置；两端只能放在同一个CPU上时跳过(显示-)" << std::endl;
+
+    return 0;
+}
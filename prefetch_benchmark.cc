@@ -0,0 +1,121 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <iomanip>
+#include <algorithm>
+#include "chan_soft_array.h"
+#include "chan_prefetch.h"
+
+// 测试参数
+constexpr size_t MIN_MESSAGES = 2 * 1024 * 1024;   // 每轮至少传递的消息数
+
+// 预取策略：两端相同距离、只有消费者预取、较远距离加行降级
+using NoPrefetch = ChanPrefetch::None;
+using Ahead4 = ChanPrefetch::Ahead<4>;
+using Ahead16 = ChanPrefetch::Ahead<16>;
+using ConsumerOnly16 = ChanPrefetch::Ahead<16, 0>;
+using Ahead16Demote = ChanPrefetch::Ahead<16, 16, true>;
+
+struct PrefetchResult {
+    double ns_per_message;
+    double throughput;        // msgs/sec
+    bool verified;
+};
+
+// 单元素push/pop(T&)，预取只作用在单元素路径上
+template<uint32_t Capacity, typename Policy>
+PrefetchResult run_policy() {
+    using Queue = SPSCQueueSoftArray<uint64_t, Capacity, 64, SpinWait, ChanLayout::SlotCompact,
+                                     ChanLayout::IndexSeparate, Policy>;
+    auto* queue = Queue::create();
+    if (!queue) {
+        std::cerr << "create失败" << std::endl;
+        exit(1);
+    }
+
+    // 至少绕环几圈，让环中每一行都反复经历一次写入和读取
+    size_t const messages = std::max(MIN_MESSAGES, static_cast<size_t>(Capacity) * 4);
+    uint64_t consumer_sum = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([queue, messages]() {
+        for (size_t i = 0; i < messages; ++i) {
+            queue->push(static_cast<uint64_t>(i));
+        }
+    });
+
+    std::thread consumer([queue, messages, &consumer_sum]() {
+        uint64_t value;
+        uint64_t sum = 0;
+        for (size_t i = 0; i < messages; ++i) {
+            queue->pop(value);
+            sum += value;
+        }
+        consumer_sum = sum;
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    Queue::destroy(queue);
+
+    uint64_t const expected = static_cast<uint64_t>(messages) * (messages - 1) / 2;
+    return {elapsed_ns / messages, messages * 1e9 / elapsed_ns, consumer_sum == expected};
+}
+
+template<uint32_t Capacity>
+void print_row(const char* level, const char* policy, double baseline_ns, const PrefetchResult& r) {
+    std::cout << std::setw(9) << Capacity << " | "
+              << std::setw(8) << sizeof(uint64_t) * Capacity / 1024 << " | "
+              << std::setw(5) << level << " | "
+              << std::setw(16) << policy << " | "
+              << std::fixed << std::setprecision(2) << std::setw(8) << r.ns_per_message << " | "
+              << std::setprecision(0) << std::setw(12) << r.throughput << " | "
+              << std::setprecision(2) << std::setw(5) << baseline_ns / r.ns_per_message << "x | "
+              << (r.verified ? "✓" : "✗") << std::endl;
+}
+
+template<uint32_t Capacity>
+void sweep_ring_size(const char* level) {
+    PrefetchResult const none = run_policy<Capacity, NoPrefetch>();
+    print_row<Capacity>(level, "none", none.ns_per_message, none);
+    print_row<Capacity>(level, "both-4", none.ns_per_message, run_policy<Capacity, Ahead4>());
+    print_row<Capacity>(level, "both-16", none.ns_per_message, run_policy<Capacity, Ahead16>());
+    print_row<Capacity>(level, "consumer-16", none.ns_per_message,
+                        run_policy<Capacity, ConsumerOnly16>());
+    if (ChanPrefetch::kDemoteAvailable) {
+        print_row<Capacity>(level, "both-16+demote", none.ns_per_message,
+                            run_policy<Capacity, Ahead16Demote>());
+    }
+}
+
+int main() {
+    std::cout << "SPSC 队列软件预取基准测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+    std::cout << "元素类型: uint64_t (每个缓存行8个槽位)，单元素push/pop" << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "cldemote: " << (ChanPrefetch::kDemoteAvailable ? "已编译" : "未编译 (需要-mcldemote或make release)")
+              << std::endl;
+    std::cout << "策略: none=无预取，both-N=两端提前N行，consumer-N=只有消费者预取，"
+              << "+demote=生产者写满一行后cldemote" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "     槽位 | 环大小KB | 层级  |             策略 | ns/消息  |  吞吐(msg/s) | 加速  | 校验" << std::endl;
+    std::cout << "----------|----------|-------|------------------|----------|--------------|-------|-----" << std::endl;
+
+    sweep_ring_size<(1u << 10)>("L1");      // 8KB
+    sweep_ring_size<(1u << 15)>("L2");      // 256KB
+    sweep_ring_size<(1u << 18)>("LLC");     // 2MB
+    sweep_ring_size<(1u << 21)>("DRAM");    // 16MB
+
+    std::cout << std::endl;
+    std::cout << "说明:" << std::endl;
+    std::cout << "• 加速为无预取的ns/消息除以该策略的ns/消息，小于1表示预取反而更慢" << std::endl;
+    std::cout << "• 环能放进L1/L2、两端距离很近时，生产者的写意图预取会从消费者手里抢走行，"
+              << "消费者的读预取会拉走生产者还没写完的行，通常得不偿失" << std::endl;
+    std::cout << "• 环超出L2后两端各自的未命中占主导，提前几行预取可以把未命中藏起来" << std::endl;
+
+    return 0;
+}
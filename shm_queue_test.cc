@@ -0,0 +1,293 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "chan_shm.h"
+
+// 测试参数
+constexpr int TEST_COUNT = 1000000;       // 吞吐量测试消息数
+constexpr int LATENCY_COUNT = 20000;      // 延迟测试消息数
+constexpr int SEND_INTERVAL_NS = 20000;   // 延迟测试中生产者的发送间隔
+constexpr uint32_t QUEUE_SIZE = 1024;
+constexpr int RECOVERY_COUNT = 10000;     // 崩溃恢复测试消息数
+constexpr int CRASH_AT = 3000;            // 第一个消费者在处理这条消息时被杀死
+
+struct Stamp {
+    uint64_t sequence;
+    int64_t send_ns;
+};
+
+using ShmQueue = SPSCQueueShm<Stamp, QUEUE_SIZE>;
+using RecoveryQueue = SPSCQueueShm<Stamp, 64, 64, YieldWait>;
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string queue_name(const char* tag) {
+    return std::string("/spsc_shm_test_") + tag + "_" + std::to_string(getpid());
+}
+
+// 生产者按固定间隔(interval_ns为0时不限速)发送count条消息
+template<typename Send>
+static void produce(int count, int64_t interval_ns, Send&& send) {
+    int64_t next_send = now_ns();
+    for (int i = 0; i < count; ++i) {
+        if (interval_ns > 0) {
+            while (now_ns() < next_send) {
+                // 忙等到发送时间点
+            }
+            next_send += interval_ns;
+        }
+        send(Stamp{static_cast<uint64_t>(i), now_ns()});
+    }
+}
+
+struct IpcResult {
+    double throughput;   // msgs/sec
+    double p50_ns;
+    double p99_ns;
+    bool in_order;
+};
+
+static void collect_latency(std::vector<int64_t>& latencies, IpcResult& result) {
+    std::sort(latencies.begin(), latencies.end());
+    result.p50_ns = latencies[latencies.size() / 2];
+    result.p99_ns = latencies[latencies.size() * 99 / 100];
+}
+
+// 子进程做生产者，父进程做消费者
+static IpcResult run_shm(int count, int64_t interval_ns) {
+    std::string name = queue_name("ipc");
+    auto* queue = ShmQueue::create_shared(name.c_str());
+    if (!queue) {
+        std::cerr << "create_shared失败: " << name << std::endl;
+        exit(1);
+    }
+    queue->register_role(ShmQueue::Role::kConsumer);
+    IpcResult result{};
+    result.in_order = true;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    pid_t child = fork();
+    if (child == 0) {
+        // 子进程按名字重新映射，验证与地址无关的布局
+        auto* producer_queue = ShmQueue::attach(name.c_str());
+        if (!producer_queue || !producer_queue->register_role(ShmQueue::Role::kProducer)) {
+            _exit(1);
+        }
+        produce(count, interval_ns, [producer_queue](const Stamp& s) { producer_queue->push(s); });
+        producer_queue->release_role(ShmQueue::Role::kProducer);
+        ShmQueue::detach(producer_queue);
+        _exit(0);
+    }
+
+    std::vector<int64_t> latencies(count);
+    Stamp item;
+    for (int i = 0; i < count; ++i) {
+        queue->pop(item);
+        latencies[i] = now_ns() - item.send_ns;
+        result.in_order &= item.sequence == static_cast<uint64_t>(i);
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    waitpid(child, nullptr, 0);
+
+    result.throughput = count * 1e9 /
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    collect_latency(latencies, result);
+
+    ShmQueue::detach(queue);
+    ShmQueue::unlink(name.c_str());
+    return result;
+}
+
+// 对照组：每条消息一次write/read系统调用的管道
+static IpcResult run_pipe(int count, int64_t interval_ns) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "pipe失败" << std::endl;
+        exit(1);
+    }
+    IpcResult result{};
+    result.in_order = true;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+    pid_t child = fork();
+    if (child == 0) {
+        close(fds[0]);
+        produce(count, interval_ns, [&fds](const Stamp& s) {
+            if (write(fds[1], &s, sizeof(s)) != sizeof(s)) {
+                _exit(1);
+            }
+        });
+        close(fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+
+    std::vector<int64_t> latencies(count);
+    Stamp item;
+    for (int i = 0; i < count; ++i) {
+        // 管道写入小于PIPE_BUF是原子的，每次read恰好拿到一条消息
+        if (read(fds[0], &item, sizeof(item)) != sizeof(item)) {
+            result.in_order = false;
+            break;
+        }
+        latencies[i] = now_ns() - item.send_ns;
+        result.in_order &= item.sequence == static_cast<uint64_t>(i);
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    close(fds[0]);
+    waitpid(child, nullptr, 0);
+
+    result.throughput = count * 1e9 /
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    collect_latency(latencies, result);
+    return result;
+}
+
+static void print_result(const char* name, const IpcResult& throughput, const IpcResult& latency) {
+    std::cout << std::setw(10) << name << " | "
+              << std::fixed << std::setprecision(0) << std::setw(14) << throughput.throughput << " | "
+              << std::setw(9) << latency.p50_ns << " | "
+              << std::setw(9) << latency.p99_ns << " | "
+              << (throughput.in_order && latency.in_order ? "有序" : "乱序!") << std::endl;
+}
+
+// 消费者进程：从队列读消息并校验序号，读到crash_at时模拟崩溃(不pop、不释放角色)
+static void recovery_consumer(const char* name, int expected_first, int crash_at) {
+    auto* queue = RecoveryQueue::attach(name);
+    if (!queue || !queue->register_role(RecoveryQueue::Role::kConsumer)) {
+        _exit(2);
+    }
+    for (int expected = expected_first; expected < RECOVERY_COUNT; ++expected) {
+        Stamp* item;
+        while (!(item = queue->front())) {
+            queue->heartbeat(RecoveryQueue::Role::kConsumer);
+            std::this_thread::yield();
+        }
+        if (item->sequence != static_cast<uint64_t>(expected)) {
+            _exit(3);
+        }
+        if (expected == crash_at) {
+            raise(SIGKILL);
+        }
+        queue->pop();
+        queue->heartbeat(RecoveryQueue::Role::kConsumer);
+    }
+    queue->release_role(RecoveryQueue::Role::kConsumer);
+    _exit(queue->generation() == 1 ? 0 : 4);
+}
+
+// 崩溃恢复测试：第一个消费者在处理CRASH_AT时被SIGKILL，生产者通过心跳发现对端消失，
+// 第二个消费者接管角色，从CRASH_AT开始继续消费(at-least-once)
+static bool run_recovery_test() {
+    std::string name = queue_name("recovery");
+    auto* queue = RecoveryQueue::create_shared(name.c_str());
+    if (!queue) {
+        return false;
+    }
+    queue->register_role(RecoveryQueue::Role::kProducer);
+    const auto stale_after = std::chrono::milliseconds(200);
+    bool ok = true;
+
+    pid_t first = fork();
+    if (first == 0) {
+        recovery_consumer(name.c_str(), 0, CRASH_AT);
+    }
+    while (!queue->peer_alive(RecoveryQueue::Role::kProducer)) {
+        std::this_thread::yield();
+    }
+
+    // 消费者存活时，其他进程不能抢占消费者角色
+    auto* intruder = RecoveryQueue::attach(name.c_str());
+    ok &= intruder != nullptr && !intruder->register_role(RecoveryQueue::Role::kConsumer);
+    RecoveryQueue::detach(intruder);
+
+    pid_t second = -1;
+    for (int i = 0; i < RECOVERY_COUNT; ++i) {
+        Stamp item{static_cast<uint64_t>(i), now_ns()};
+        while (!queue->try_push(item)) {
+            if (second < 0 && !queue->peer_alive(RecoveryQueue::Role::kProducer, stale_after)) {
+                int status = 0;
+                waitpid(first, &status, 0);
+                std::cout << "检测到消费者崩溃(信号 " << (WIFSIGNALED(status) ? WTERMSIG(status) : 0)
+                          << ")，队列中剩余 " << queue->size() << " 条，启动新的消费者接管" << std::endl;
+                second = fork();
+                if (second == 0) {
+                    recovery_consumer(name.c_str(), CRASH_AT, -1);
+                }
+            }
+            queue->heartbeat(RecoveryQueue::Role::kProducer);
+            std::this_thread::yield();
+        }
+    }
+
+    if (second < 0) {
+        std::cout << "消费者没有按预期崩溃" << std::endl;
+        ok = false;
+        waitpid(first, nullptr, 0);
+    } else {
+        int status = 0;
+        waitpid(second, &status, 0);
+        ok &= WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        std::cout << "接管后的消费者退出码: " << (WIFEXITED(status) ? WEXITSTATUS(status) : -1)
+                  << "，角色接管次数: " << queue->generation() << std::endl;
+    }
+
+    queue->release_role(RecoveryQueue::Role::kProducer);
+    RecoveryQueue::detach(queue);
+    RecoveryQueue::unlink(name.c_str());
+    return ok;
+}
+
+// 头部校验：模板参数不一致的进程不能attach，同名队列不能重复创建
+static bool run_header_test() {
+    std::string name = queue_name("header");
+    auto* queue = ShmQueue::create_shared(name.c_str());
+    if (!queue) {
+        return false;
+    }
+    bool ok = ShmQueue::create_shared(name.c_str()) == nullptr;
+    ok &= SPSCQueueShm<Stamp, QUEUE_SIZE / 2>::attach(name.c_str()) == nullptr;
+    ok &= SPSCQueueShm<int64_t, QUEUE_SIZE * 2>::attach(name.c_str()) == nullptr;
+    auto* again = ShmQueue::attach(name.c_str());
+    ok &= again != nullptr;
+    ShmQueue::detach(again);
+    ShmQueue::detach(queue);
+    ShmQueue::unlink(name.c_str());
+    return ok;
+}
+
+int main() {
+    std::cout << "SPSC 共享内存跨进程队列测试" << std::endl;
+    std::cout << "============================" << std::endl;
+    std::cout << "吞吐量测试消息数: " << TEST_COUNT << std::endl;
+    std::cout << "延迟测试消息数: " << LATENCY_COUNT
+              << " (发送间隔 " << SEND_INTERVAL_NS / 1000 << " 微秒)" << std::endl;
+    std::cout << "共享内存队列对象大小: " << sizeof(ShmQueue) << " 字节" << std::endl;
+
+    std::cout << "\n      传输 |   吞吐量(msg/s) |  p50(ns) |  p99(ns) | 顺序" << std::endl;
+    std::cout << "-----------|----------------|-----------|-----------|------" << std::endl;
+    print_result("shm-queue", run_shm(TEST_COUNT, 0), run_shm(LATENCY_COUNT, SEND_INTERVAL_NS));
+    print_result("pipe", run_pipe(TEST_COUNT, 0), run_pipe(LATENCY_COUNT, SEND_INTERVAL_NS));
+
+    std::cout << "\n头部校验测试" << std::endl;
+    bool header_ok = run_header_test();
+    std::cout << (header_ok ? "✓ 通过" : "✗ 失败") << std::endl;
+
+    std::cout << "\n崩溃恢复测试 (" << RECOVERY_COUNT << " 条消息，消费者在第 " << CRASH_AT << " 条时被杀死)" << std::endl;
+    bool recovery_ok = run_recovery_test();
+    std::cout << (recovery_ok ? "✓ 通过" : "✗ 失败") << std::endl;
+
+    std::cout << "\n说明: p50/p99为低负载下的单向延迟；shm-queue的快路径没有系统调用，"
+              << "pipe每条消息至少一次write和一次read" << std::endl;
+
+    return header_ok && recovery_ok ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include "chan_soft_array.h"
+#include "chan_clock.h"
+
+// 测试参数
+constexpr int REPEAT_COUNT = 200;   // 每个超时时长的重复次数
+constexpr uint32_t QUEUE_SIZE = 64;
+const int64_t TIMEOUTS_US[] = {1, 10, 50, 200, 1000};
+
+struct PrecisionStats {
+    double mean_overshoot_ns;
+    double p50_overshoot_ns;
+    double p99_overshoot_ns;
+    double max_overshoot_ns;
+    int early_returns;       // 早于截止时间返回的次数(应为0)
+};
+
+static PrecisionStats summarize(std::vector<int64_t>& overshoots) {
+    PrecisionStats stats{};
+    std::sort(overshoots.begin(), overshoots.end());
+    stats.mean_overshoot_ns = std::accumulate(overshoots.begin(), overshoots.end(), 0.0) / overshoots.size();
+    stats.p50_overshoot_ns = overshoots[overshoots.size() / 2];
+    stats.p99_overshoot_ns = overshoots[overshoots.size() * 99 / 100];
+    stats.max_overshoot_ns = overshoots.back();
+    stats.early_returns = static_cast<int>(std::count_if(overshoots.begin(), overshoots.end(),
+                                                         [](int64_t v) { return v < 0; }));
+    return stats;
+}
+
+static void print_stats(const char* op, int64_t timeout_us, const PrecisionStats& s) {
+    std::cout << "  " << std::setw(8) << op << " | " << std::setw(6) << timeout_us << " | "
+              << std::fixed << std::setprecision(0)
+              << std::setw(10) << s.mean_overshoot_ns << " | "
+              << std::setw(10) << s.p50_overshoot_ns << " | "
+              << std::setw(10) << s.p99_overshoot_ns << " | "
+              << std::setw(10) << s.max_overshoot_ns << " | "
+              << std::setw(4) << s.early_returns << std::endl;
+}
+
+// 在空队列上调用pop_for、在满队列上调用push_for，测量实际返回时间相对超时时长的偏差
+template<typename WaitPolicy>
+void timeout_precision_test(const std::string& name) {
+    using Queue = SPSCQueueSoftArray<int, QUEUE_SIZE, 64, WaitPolicy>;
+    auto* queue = Queue::create();
+
+    std::cout << "\n等待策略: " << name << std::endl;
+    std::cout << "  操作     | 超时us | 平均超出ns | 中位超出ns |  p99超出ns | 最大超出ns | 提前" << std::endl;
+
+    for (int64_t timeout_us : TIMEOUTS_US) {
+        const auto timeout = std::chrono::microseconds(timeout_us);
+        std::vector<int64_t> overshoots;
+        overshoots.reserve(REPEAT_COUNT);
+
+        // 空队列：pop_for必然超时
+        for (int i = 0; i < REPEAT_COUNT; ++i) {
+            int value;
+            auto start = std::chrono::steady_clock::now();
+            bool ok = queue->pop_for(value, timeout);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (ok) {
+                std::cerr << "空队列上pop_for意外成功" << std::endl;
+            }
+            overshoots.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - timeout).count());
+        }
+        PrecisionStats pop_stats = summarize(overshoots);
+
+        // 填满队列：push_for必然超时
+        while (queue->try_push(0)) {
+        }
+        overshoots.clear();
+        for (int i = 0; i < REPEAT_COUNT; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            bool ok = queue->push_for(timeout, 1);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            if (ok) {
+                std::cerr << "满队列上push_for意外成功" << std::endl;
+            }
+            overshoots.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - timeout).count());
+        }
+        PrecisionStats push_stats = summarize(overshoots);
+        while (queue->front()) {
+            queue->pop();
+        }
+
+        print_stats("pop_for", timeout_us, pop_stats);
+        print_stats("push_for", timeout_us, push_stats);
+    }
+
+    Queue::destroy(queue);
+}
+
+// 极大的超时(nanoseconds::max()、约280年)在now + timeout或换算成tick时会溢出，
+// 溢出后截止时间落在过去，调用立即返回false。另一线程延迟PEER_DELAY_MS后才让操作可以完成，
+// 正确饱和时调用一直等到那时并返回true
+constexpr int PEER_DELAY_MS = 50;
+
+template<typename Queue, typename Op>
+static void check_huge_timeout(Queue* queue, const char* label, Op op, bool producer_peer) {
+    std::thread peer([queue, producer_peer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(PEER_DELAY_MS));
+        if (producer_peer) {
+            queue->push(1);
+        } else {
+            queue->pop();
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    bool ok = op();
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    peer.join();
+    bool const passed = ok && elapsed_ms >= PEER_DELAY_MS - 1;
+    std::cout << "  " << std::left << std::setw(34) << label << std::right
+              << " | " << std::setw(4) << elapsed_ms << " ms | "
+              << (passed ? "OK" : "立即返回(溢出)") << std::endl;
+}
+
+void huge_timeout_test() {
+    using Queue = SPSCQueueSoftArray<int, QUEUE_SIZE, 64, SpinThenSleepWait<>>;
+    auto* queue = Queue::create();
+    const auto max_ns = std::chrono::nanoseconds::max();
+    const auto years_280 = std::chrono::hours(24 * 365 * 280);
+
+    std::cout << "\n极大超时 (应等到另一线程 " << PEER_DELAY_MS << " ms 后操作才返回true)" << std::endl;
+    int value;
+    check_huge_timeout(queue, "pop_for(nanoseconds::max())",
+                       [&]() { return queue->pop_for(value, max_ns); }, true);
+    check_huge_timeout(queue, "pop_for(280年)",
+                       [&]() { return queue->pop_for(value, years_280); }, true);
+    check_huge_timeout(queue, "pop_until(time_point::max())",
+                       [&]() { return queue->pop_until(value, std::chrono::steady_clock::time_point::max()); },
+                       true);
+
+    while (queue->try_push(0)) {
+    }
+    check_huge_timeout(queue, "push_for(nanoseconds::max())",
+                       [&]() { return queue->push_for(max_ns, 1); }, false);
+    check_huge_timeout(queue, "push_for(280年)",
+                       [&]() { return queue->push_for(years_280, 1); }, false);
+    while (queue->front()) {
+        queue->pop();
+    }
+
+    Queue::destroy(queue);
+}
+
+// 进程中的第一次限时调用：TSC频率如果拖到这时才校准，调用会多忙等约2毫秒。
+// 必须在main()中任何其他ChanClock调用之前测量，不能先预热
+constexpr int64_t COLD_TIMEOUT_US = 10;
+constexpr int64_t COLD_OVERSHOOT_LIMIT_US = 500;
+
+static int64_t first_timed_call_overshoot_ns() {
+    using Queue = SPSCQueueSoftArray<int, QUEUE_SIZE, 64, SpinWait>;
+    auto* queue = Queue::create();
+    const auto timeout = std::chrono::microseconds(COLD_TIMEOUT_US);
+    int value;
+    auto start = std::chrono::steady_clock::now();
+    queue->pop_for(value, timeout);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    Queue::destroy(queue);
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - timeout).count();
+}
+
+int main() {
+    int64_t const cold_overshoot_ns = first_timed_call_overshoot_ns();
+
+    std::cout << "SPSC 队列限时操作精度测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+    std::cout << "进程中第一次pop_for(" << COLD_TIMEOUT_US << "us) 超出: " << cold_overshoot_ns << " ns "
+              << (cold_overshoot_ns < COLD_OVERSHOOT_LIMIT_US * 1000 ? "OK" : "过长(首次调用时才校准TSC)")
+              << std::endl;
+    std::cout << "每个超时时长重复次数: " << REPEAT_COUNT << std::endl;
+    std::cout << "TSC频率: " << std::fixed << std::setprecision(3)
+              << ChanClock::ticks_per_ns() << " ticks/ns" << std::endl;
+
+    timeout_precision_test<SpinWait>("spin");
+    timeout_precision_test<PauseWait>("pause");
+    timeout_precision_test<SpinThenSleepWait<>>("spin-then-sleep");
+    huge_timeout_test();
+
+    std::cout << "\n说明: 超出 = 实际返回时间 - 超时时长；spin/pause只受TSC读取粒度影响，"
+              << "spin-then-sleep在进入睡眠后会超出约一个睡眠粒度" << std::endl;
+
+    return 0;
+}
@@ -8,6 +8,11 @@
 #include <vector>
 #include <iomanip>
 #include <functional>
+#include <cstdio>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
 
 // 示例1: 基础使用
 void basic_usage_example() {
@@ -279,6 +284,141 @@ void best_practices_example() {
     // guard析构时会自动调用destroy
 }
 
+// 示例5: 非阻塞 try_push / try_pop
+void non_blocking_example() {
+    std::cout << "\n=== 非阻塞接口示例 ===" << std::endl;
+    
+    using Queue = SPSCQueueSoftArray<int, 64, 64>;
+    auto* queue = Queue::create();
+    if (!queue) {
+        std::cerr << "队列创建失败!" << std::endl;
+        return;
+    }
+    
+    // 生产者：队列满时不等待，直接丢弃(实际场景中可转移到备用通道)
+    int accepted = 0;
+    int dropped = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (queue->try_push(i)) {
+            accepted++;
+        } else {
+            dropped++;
+        }
+    }
+    std::cout << "接受: " << accepted << ", 丢弃: " << dropped << std::endl;
+    
+    // 消费者：取空队列
+    int value = 0;
+    int received = 0;
+    while (queue->try_pop(value)) {
+        received++;
+    }
+    std::cout << "取出: " << received << ", 最后一个值: " << value << std::endl;
+    
+    Queue::destroy(queue);
+}
+
+// 示例6: reserve/commit 零拷贝写入
+struct Message {
+    uint64_t sequence;
+    uint32_t length;
+    char payload[48];
+};
+
+void zero_copy_example() {
+    std::cout << "\n=== 零拷贝写入示例 ===" << std::endl;
+    
+    using Queue = SPSCQueueSoftArray<Message, 256, 64>;
+    auto* queue = Queue::create();
+    if (!queue) {
+        std::cerr << "队列创建失败!" << std::endl;
+        return;
+    }
+    
+    // 生产者：直接在队列内存中逐字段构造一组消息，一次commit整组可见
+    const size_t group = 4;
+    auto slots = queue->reserve(group);
+    if (slots.size() == group) {
+        for (size_t i = 0; i < group; ++i) {
+            Message* msg = new (&slots[i]) Message;
+            msg->sequence = i;
+            msg->length = static_cast<uint32_t>(
+                std::snprintf(msg->payload, sizeof(msg->payload), "message-%zu", i));
+        }
+        queue->commit(group);
+    }
+    
+    // 消费者
+    while (auto* msg = queue->front()) {
+        std::cout << "收到消息 #" << msg->sequence << ": " << msg->payload << std::endl;
+        queue->pop();
+    }
+    
+    Queue::destroy(queue);
+}
+
+// 示例7: eventfd + epoll 事件循环
+#ifdef __linux__
+void epoll_example() {
+    std::cout << "\n=== eventfd + epoll 示例 ===" << std::endl;
+    
+    using Queue = SPSCQueueSoftArray<int, 1024, 64>;
+    auto* queue = Queue::create();
+    if (!queue || queue->enable_eventfd() < 0) {
+        std::cerr << "队列或eventfd创建失败!" << std::endl;
+        if (queue) Queue::destroy(queue);
+        return;
+    }
+    
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = queue->event_fd();
+    epoll_ctl(epfd, EPOLL_CTL_ADD, queue->event_fd(), &ev);
+    
+    const int BURSTS = 20;
+    const int BURST_SIZE = 500;
+    
+    // 生产者：间歇性地发送突发流量
+    std::thread producer([queue]() {
+        for (int burst = 0; burst < BURSTS; ++burst) {
+            for (int i = 0; i < BURST_SIZE; ++i) {
+                queue->push(burst * BURST_SIZE + i);
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+    });
+    
+    // 消费者：事件循环中队列fd和其他fd(socket、timer)一起等待
+    int received = 0;
+    int wakeups = 0;
+    while (received < BURSTS * BURST_SIZE) {
+        while (queue->front()) {
+            queue->pop();
+            received++;
+        }
+        if (received == BURSTS * BURST_SIZE) {
+            break;
+        }
+        // 先置位通知标志并再次检查队列，仍为空才进入epoll_wait
+        if (queue->arm_notification()) {
+            epoll_event events[4];
+            if (epoll_wait(epfd, events, 4, 100) > 0) {
+                queue->consume_notification();
+                wakeups++;
+            }
+        }
+    }
+    
+    producer.join();
+    std::cout << "收到消息: " << received << ", epoll唤醒次数: " << wakeups
+              << " (每条消息不会触发一次系统调用)" << std::endl;
+    
+    close(epfd);
+    Queue::destroy(queue);
+}
+#endif
+
 int main() {
     std::cout << "SPSC队列使用示例集合" << std::endl;
     std::cout << "===================" << std::endl;
@@ -288,6 +428,11 @@ int main() {
         high_performance_example();
         cacheline_comparison_example();
         best_practices_example();
+        non_blocking_example();
+        zero_copy_example();
+#ifdef __linux__
+        epoll_example();
+#endif
         
         std::cout << "\n所有示例运行完成!" << std::endl;
     } catch (const std::exception& e) {
@@ -0,0 +1,180 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <algorithm>
+#include <ctime>
+#include "chan_soft_array.h"
+#include "chan_wait.h"
+
+// 测试参数
+constexpr int TEST_COUNT = 1000000;       // 吞吐量测试消息数
+constexpr int LATENCY_COUNT = 20000;      // 延迟测试消息数
+constexpr int SEND_INTERVAL_NS = 20000;   // 延迟测试中生产者的发送间隔
+constexpr uint32_t QUEUE_SIZE = 1024;
+
+struct Stamp {
+    uint64_t sequence;
+    int64_t send_ns;
+};
+
+struct WaitResult {
+    double throughput;           // ops/sec
+    double p50_ns;
+    double p99_ns;
+    double producer_cpu_ratio;   // 吞吐量测试中生产者CPU时间 / 墙钟时间
+    double consumer_cpu_ratio;   // 吞吐量测试中消费者CPU时间 / 墙钟时间
+    double idle_consumer_cpu_ratio;  // 延迟测试(低负载)中消费者CPU时间 / 墙钟时间
+};
+
+static int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 当前线程消耗的CPU时间
+static int64_t thread_cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// 使用WaitPolicy的阻塞push/pop
+template<typename WaitPolicy>
+struct BlockingOps {
+    using Queue = SPSCQueueSoftArray<Stamp, QUEUE_SIZE, 64, WaitPolicy>;
+    static const char* name() { return WaitPolicy::name(); }
+    static void push(Queue* queue, const Stamp& item) { queue->push(item); }
+    static void pop(Queue* queue, Stamp& item) { queue->pop(item); }
+};
+
+// 自适应自旋 + futex休眠的push_wait/pop_wait
+struct ParkingOps {
+    using Queue = SPSCQueueSoftArray<Stamp, QUEUE_SIZE, 64>;
+    static const char* name() { return "futex-park"; }
+    static void push(Queue* queue, const Stamp& item) { queue->push_wait(item); }
+    static void pop(Queue* queue, Stamp& item) { queue->pop_wait(item); }
+};
+
+template<typename Ops>
+WaitResult run_wait_policy() {
+    using Queue = typename Ops::Queue;
+    auto* queue = Queue::create();
+    WaitResult result{};
+
+    // 吞吐量测试：生产者和消费者都使用阻塞接口，满/空时按策略等待
+    int64_t producer_cpu = 0;
+    int64_t consumer_cpu = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([queue, &producer_cpu]() {
+        int64_t cpu_start = thread_cpu_ns();
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            Ops::push(queue, Stamp{static_cast<uint64_t>(i), 0});
+        }
+        producer_cpu = thread_cpu_ns() - cpu_start;
+    });
+
+    std::thread consumer([queue, &consumer_cpu]() {
+        int64_t cpu_start = thread_cpu_ns();
+        Stamp item;
+        for (int i = 0; i < TEST_COUNT; ++i) {
+            Ops::pop(queue, item);
+        }
+        consumer_cpu = thread_cpu_ns() - cpu_start;
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    double wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
+    result.throughput = TEST_COUNT * 1e9 / wall_ns;
+    result.producer_cpu_ratio = producer_cpu / wall_ns;
+    result.consumer_cpu_ratio = consumer_cpu / wall_ns;
+
+    // 延迟测试：生产者按固定间隔发送，消费者大部分时间在等待
+    std::vector<int64_t> latencies(LATENCY_COUNT);
+    int64_t idle_consumer_cpu = 0;
+    int64_t idle_start = now_ns();
+
+    std::thread paced_producer([queue]() {
+        int64_t next_send = now_ns();
+        for (int i = 0; i < LATENCY_COUNT; ++i) {
+            while (now_ns() < next_send) {
+                // 忙等到发送时间点，保证发送节奏准确
+            }
+            Ops::push(queue, Stamp{static_cast<uint64_t>(i), now_ns()});
+            next_send += SEND_INTERVAL_NS;
+        }
+    });
+
+    std::thread waiting_consumer([queue, &latencies, &idle_consumer_cpu]() {
+        int64_t cpu_start = thread_cpu_ns();
+        Stamp item;
+        for (int i = 0; i < LATENCY_COUNT; ++i) {
+            Ops::pop(queue, item);
+            latencies[i] = now_ns() - item.send_ns;
+        }
+        idle_consumer_cpu = thread_cpu_ns() - cpu_start;
+    });
+
+    paced_producer.join();
+    waiting_consumer.join();
+
+    double idle_wall_ns = static_cast<double>(now_ns() - idle_start);
+    result.idle_consumer_cpu_ratio = idle_consumer_cpu / idle_wall_ns;
+
+    std::sort(latencies.begin(), latencies.end());
+    result.p50_ns = latencies[latencies.size() / 2];
+    result.p99_ns = latencies[latencies.size() * 99 / 100];
+
+    Queue::destroy(queue);
+    return result;
+}
+
+template<typename Ops>
+void report_wait_policy() {
+    WaitResult r = run_wait_policy<Ops>();
+    std::cout << std::setw(16) << Ops::name() << " | "
+              << std::fixed << std::setprecision(0) << std::setw(14) << r.throughput << " | "
+              << std::setw(9) << r.p50_ns << " | "
+              << std::setw(9) << r.p99_ns << " | "
+              << std::setprecision(1) << std::setw(7) << r.producer_cpu_ratio * 100 << "% | "
+              << std::setw(7) << r.consumer_cpu_ratio * 100 << "% | "
+              << std::setw(7) << r.idle_consumer_cpu_ratio * 100 << "%" << std::endl;
+}
+
+int main() {
+    std::cout << "SPSC 队列等待策略基准测试" << std::endl;
+    std::cout << "==========================" << std::endl;
+    std::cout << "吞吐量测试消息数: " << TEST_COUNT << std::endl;
+    std::cout << "延迟测试消息数: " << LATENCY_COUNT
+              << " (发送间隔 " << SEND_INTERVAL_NS / 1000 << " 微秒)" << std::endl;
+    std::cout << "硬件线程数: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "CPU列含义: 吞吐量测试中生产者/消费者的CPU时间占墙钟时间的比例，"
+              << "以及低负载延迟测试中消费者的CPU占用" << std::endl;
+    std::cout << std::endl;
+    std::cout << "        等待策略 |   吞吐量(ops/s) |  p50(ns) |  p99(ns) | 生产CPU | 消费CPU | 空闲CPU" << std::endl;
+    std::cout << "-----------------|----------------|-----------|-----------|---------|---------|---------" << std::endl;
+
+    report_wait_policy<BlockingOps<SpinWait>>();
+    report_wait_policy<BlockingOps<PauseWait>>();
+    report_wait_policy<BlockingOps<BackoffWait<>>>();
+    report_wait_policy<BlockingOps<YieldWait>>();
+    report_wait_policy<BlockingOps<SpinThenSleepWait<>>>();
+    report_wait_policy<ParkingOps>();
+
+    std::cout << std::endl;
+    std::cout << "说明:" << std::endl;
+    std::cout << "• spin/pause 延迟最低，但空闲时也会占满一个核" << std::endl;
+    std::cout << "• yield 在没有其他可运行线程时仍接近100% CPU，只是让出给同核的其他线程" << std::endl;
+    std::cout << "• spin-then-sleep 空闲CPU低，代价是唤醒延迟接近睡眠粒度" << std::endl;
+    std::cout << "• futex-park 根据最近的等待时长自适应自旋后休眠，由对端按需唤醒，"
+              << "空闲CPU低且唤醒延迟为微秒级" << std::endl;
+
+    return 0;
+}